@@ -0,0 +1,50 @@
+#ifndef __ADC_OVERSAMPLE_H
+#define __ADC_OVERSAMPLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Nadpróbkowanie i decymacja wyników ADC (AVR121): suma 4^n kolejnych
+// próbek przesunięta w prawo o n bitów daje wynik o rozdzielczości 10 + n
+// bitów, za to 4^n razy rzadziej. Działa tylko wtedy, gdy sygnał ma szum
+// rzędu co najmniej 1 LSB, który rozrzuca kolejne próbki.
+//
+// adc_oversample_add jest przeznaczone do wołania w ADC_vect: to jedno
+// dodawanie, inkrementacja i porównanie na próbkę. Dla n <= 3 suma
+// (64 * 1023) mieści się w 16 bitach.
+
+#define ADC_OVERSAMPLE_MAX_BITS 3
+
+typedef struct {
+    uint16_t accumulator;
+    uint8_t count;
+    uint8_t ratio;
+    uint8_t bits;
+    uint16_t result;
+} adc_oversample_t;
+
+/* bits to liczba dodatkowych bitów (0..3), współczynnik to 4^bits */
+static inline void adc_oversample_initialize(adc_oversample_t* oversample, uint8_t bits) {
+    if (bits > ADC_OVERSAMPLE_MAX_BITS) {
+        bits = ADC_OVERSAMPLE_MAX_BITS;
+    }
+    oversample->accumulator = 0;
+    oversample->count = 0;
+    oversample->bits = bits;
+    oversample->ratio = 1 << (2 * bits);
+    oversample->result = 0;
+}
+
+/* Dodaje próbkę; zwraca true, gdy w result jest nowy zdecymowany wynik */
+static inline bool adc_oversample_add(adc_oversample_t* oversample, uint16_t sample) {
+    oversample->accumulator += sample;
+    if (++oversample->count != oversample->ratio) {
+        return false;
+    }
+    oversample->result = oversample->accumulator >> oversample->bits;
+    oversample->accumulator = 0;
+    oversample->count = 0;
+    return true;
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include "adc_scan.h"
+#include "adc_oversample.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <util/atomic.h>
+
+#define BUFFER_MASK (ADC_SCAN_BUFFER_SIZE - 1)
+
+_Static_assert((ADC_SCAN_BUFFER_SIZE & BUFFER_MASK) == 0 && ADC_SCAN_BUFFER_SIZE <= 128,
+               "ADC_SCAN_BUFFER_SIZE must be a power of two <= 128");
+
+typedef struct {
+    uint8_t mux;
+    adc_oversample_t oversample;
+    volatile uint16_t latest;
+    volatile uint16_t overruns;
+    // bufor jak w ring_buffer.h: liczniki rosną bez ograniczeń, indeks to
+    // licznik & BUFFER_MASK; head pisze tylko przerwanie, tail tylko konsument
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    adc_sample_t samples[ADC_SCAN_BUFFER_SIZE];
+} channel_t;
+
+static channel_t channels[ADC_SCAN_MAX_CHANNELS];
+static uint8_t channels_count;
+static uint8_t reference_bits;
+static bool free_running;
+
+// flaga timera, którą trzeba skasować, żeby kolejne zdarzenie wyzwoliło ADC
+static volatile uint8_t* trigger_flag_register;
+static uint8_t trigger_flag;
+
+// Kanał, którego konwersja właśnie trwa, i kanał wpisany do ADMUX (zostanie
+// użyty przy starcie następnej konwersji). W trybie free running kolejna
+// konwersja startuje od razu po zakończeniu poprzedniej, czyli zanim
+// przerwanie zmieni ADMUX -- stąd dwa etapy.
+static uint8_t converting_index;
+static uint8_t selected_index;
+
+static volatile uint16_t conversions;
+
+static inline uint8_t next_index(uint8_t index) {
+    index++;
+    return index == channels_count ? 0 : index;
+}
+
+static inline void store_sample(channel_t* channel, uint16_t timestamp, uint16_t value) {
+    channel->latest = value;
+    const uint8_t head = channel->head;
+    if ((uint8_t)(head - channel->tail) == ADC_SCAN_BUFFER_SIZE) {
+        channel->overruns++;
+    } else {
+        adc_sample_t* sample = &channel->samples[head & BUFFER_MASK];
+        sample->timestamp = timestamp;
+        sample->value = value;
+        __asm__ __volatile__("" ::: "memory");
+        channel->head = head + 1;
+    }
+}
+
+ISR(ADC_vect) {
+    const uint16_t value = ADC;
+    const uint16_t timestamp = conversions++;
+
+    channel_t* channel = &channels[converting_index];
+    if (channel->oversample.bits == 0) {
+        store_sample(channel, timestamp, value);
+    } else if (adc_oversample_add(&channel->oversample, value)) {
+        store_sample(channel, timestamp, channel->oversample.result);
+    }
+
+    if (free_running) {
+        converting_index = selected_index;
+        selected_index = next_index(selected_index);
+    } else {
+        selected_index = next_index(selected_index);
+        converting_index = selected_index;
+        *trigger_flag_register = trigger_flag;
+    }
+    ADMUX = reference_bits | channels[selected_index].mux;
+}
+
+void adc_scan_initialize(const uint8_t* channel_list, uint8_t count, uint8_t reference, adc_scan_trigger_t trigger) {
+    if (count > ADC_SCAN_MAX_CHANNELS) {
+        count = ADC_SCAN_MAX_CHANNELS;
+    }
+    channels_count = count;
+    reference_bits = reference & (_BV(REFS1) | _BV(REFS0));
+    free_running = trigger == ADC_SCAN_FREE_RUNNING;
+
+    for (uint8_t index = 0; index < count; index++) {
+        channel_t* channel = &channels[index];
+        channel->mux = channel_list[index] & 0x0f;
+        adc_oversample_initialize(&channel->oversample, 0);
+        channel->latest = 0;
+        channel->overruns = 0;
+        channel->head = 0;
+        channel->tail = 0;
+        // wyłącz wejście cyfrowe na kanałach ADC0..5
+        if (channel->mux < 6) {
+            DIDR0 |= _BV(channel->mux);
+        }
+    }
+
+    switch (trigger) {
+    case ADC_SCAN_TIMER0_COMPARE_A:
+        trigger_flag_register = &TIFR0;
+        trigger_flag = _BV(OCF0A);
+        break;
+    case ADC_SCAN_TIMER0_OVERFLOW:
+        trigger_flag_register = &TIFR0;
+        trigger_flag = _BV(TOV0);
+        break;
+    case ADC_SCAN_TIMER1_COMPARE_B:
+        trigger_flag_register = &TIFR1;
+        trigger_flag = _BV(OCF1B);
+        break;
+    case ADC_SCAN_TIMER1_OVERFLOW:
+        trigger_flag_register = &TIFR1;
+        trigger_flag = _BV(TOV1);
+        break;
+    case ADC_SCAN_TIMER1_CAPTURE:
+        trigger_flag_register = &TIFR1;
+        trigger_flag = _BV(ICF1);
+        break;
+    default:
+        trigger_flag_register = &TIFR1;
+        trigger_flag = 0;
+        break;
+    }
+
+    ADCSRA = ADC_SCAN_PRESCALER;
+    ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | trigger;
+    ADCSRA |= _BV(ADEN); // włącz ADC
+}
+
+void adc_scan_start(void) {
+    if (channels_count == 0) {
+        return;
+    }
+    converting_index = 0;
+    selected_index = 0;
+    ADMUX = reference_bits | channels[0].mux;
+    ADCSRA |= _BV(ADIF); // wyczyść stary wynik (pisząc 1!)
+    ADCSRA |= _BV(ADIE) | _BV(ADATE);
+    if (free_running) {
+        ADCSRA |= _BV(ADSC); // pierwsza konwersja, kolejne startują same
+    }
+}
+
+void adc_scan_stop(void) {
+    ADCSRA &= ~(_BV(ADIE) | _BV(ADATE));
+    // poczekaj na ewentualną trwającą konwersję
+    loop_until_bit_is_clear(ADCSRA, ADSC);
+}
+
+uint16_t adc_scan_latest(uint8_t index) {
+    uint16_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        value = channels[index].latest;
+    }
+    return value;
+}
+
+bool adc_scan_read(uint8_t index, adc_sample_t* sample) {
+    return adc_scan_read_n(index, sample, 1) == 1;
+}
+
+uint8_t adc_scan_read_n(uint8_t index, adc_sample_t* samples, uint8_t count) {
+    channel_t* channel = &channels[index];
+    uint8_t tail = channel->tail;
+    const uint8_t available = channel->head - tail;
+    if (count > available) {
+        count = available;
+    }
+    __asm__ __volatile__("" ::: "memory");
+    for (uint8_t read = 0; read < count; read++) {
+        samples[read] = channel->samples[tail & BUFFER_MASK];
+        tail++;
+    }
+    __asm__ __volatile__("" ::: "memory");
+    channel->tail = tail;
+    return count;
+}
+
+uint8_t adc_scan_available(uint8_t index) {
+    return channels[index].head - channels[index].tail;
+}
+
+uint16_t adc_scan_overruns(uint8_t index) {
+    uint16_t overruns;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        overruns = channels[index].overruns;
+    }
+    return overruns;
+}
+
+void adc_scan_set_oversampling(uint8_t index, uint8_t bits) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        adc_oversample_initialize(&channels[index].oversample, bits);
+    }
+}
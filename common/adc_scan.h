@@ -0,0 +1,67 @@
+#ifndef __ADC_SCAN_H
+#define __ADC_SCAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Skanowanie kilku kanałów ADC w całości z przerwania ADC_vect.
+//
+// ADC pracuje w trybie auto-trigger (free running albo wyzwalany zdarzeniem
+// timera), a przerwanie po każdej konwersji zapisuje wynik do bufora
+// kanału i ustawia w ADMUX kolejny kanał z listy. Konsument czyta ostatnią
+// wartość (adc_scan_latest) albo wyciąga próbki ze znacznikami czasu z
+// bufora kanału (adc_scan_read, adc_scan_read_n). Bufory są typu jeden
+// producent / jeden konsument jak w ring_buffer.h.
+//
+// Znacznik czasu to 16-bitowy licznik konwersji: w trybie free running
+// jedna konwersja trwa 13 cykli zegara ADC (104 us przy preskalerze 128),
+// w trybie wyzwalanym -- jeden okres wyzwalającego timera.
+//
+// Kanał może mieć włączone nadpróbkowanie (adc_oversample.h): wtedy do
+// bufora i do adc_scan_latest trafia co 4^n-ta, zdecymowana wartość
+// o rozdzielczości 10 + n bitów, ze znacznikiem czasu ostatniej konwersji.
+//
+// W trybie wyzwalanym timer musi dawać zdarzenia rzadziej niż trwa
+// konwersja plus obsługa przerwania, inaczej nowy kanał nie zdąży się
+// ustawić. Flagę zdarzenia timera czyści przerwanie ADC, więc timer nie
+// potrzebuje własnego przerwania.
+
+#ifndef ADC_SCAN_MAX_CHANNELS
+#define ADC_SCAN_MAX_CHANNELS 4
+#endif
+
+#ifndef ADC_SCAN_BUFFER_SIZE
+#define ADC_SCAN_BUFFER_SIZE 16 // na kanał, potęga dwójki <= 128
+#endif
+
+#ifndef ADC_SCAN_PRESCALER
+#define ADC_SCAN_PRESCALER (_BV(ADPS0) | _BV(ADPS1) | _BV(ADPS2)) // preskaler 128
+#endif
+
+// wartości ADTS z ADCSRB
+typedef enum {
+    ADC_SCAN_FREE_RUNNING = 0,
+    ADC_SCAN_TIMER0_COMPARE_A = 3,
+    ADC_SCAN_TIMER0_OVERFLOW = 4,
+    ADC_SCAN_TIMER1_COMPARE_B = 5,
+    ADC_SCAN_TIMER1_OVERFLOW = 6,
+    ADC_SCAN_TIMER1_CAPTURE = 7,
+} adc_scan_trigger_t;
+
+typedef struct {
+    uint16_t timestamp;
+    uint16_t value;
+} adc_sample_t;
+
+/* channels to numery wejść (0..7, 14 = 1.1V); reference to bity REFS z ADMUX */
+void adc_scan_initialize(const uint8_t* channels, uint8_t count, uint8_t reference, adc_scan_trigger_t trigger);
+void adc_scan_start(void);
+void adc_scan_stop(void);
+uint16_t adc_scan_latest(uint8_t index);                /* Ostatni wynik kanału o danym indeksie na liście */
+bool adc_scan_read(uint8_t index, adc_sample_t* sample); /* Najstarsza próbka z bufora kanału */
+uint8_t adc_scan_read_n(uint8_t index, adc_sample_t* samples, uint8_t count);
+uint8_t adc_scan_available(uint8_t index);             /* Liczba próbek w buforze kanału */
+uint16_t adc_scan_overruns(uint8_t index);             /* Liczba próbek utraconych przy pełnym buforze */
+void adc_scan_set_oversampling(uint8_t index, uint8_t bits); /* 4^bits próbek na wynik, 0 wyłącza */
+
+#endif
@@ -0,0 +1,103 @@
+#include "back_emf.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <util/atomic.h>
+
+
+static volatile uint16_t filtered = 0; // z 4 bitami części ułamkowej
+static volatile uint16_t auxiliary = 0;
+static volatile back_emf_handler_t handler = NULL;
+static bool primed = false;
+
+ISR(TIMER1_OVF_vect) {
+    // wyzwolenie jest na zboczu flagi, trzeba ją wyczyścić przed kolejnym pomiarem
+    TIFR1 = _BV(OCF1B);
+}
+
+ISR(ADC_vect) {
+#ifdef BACK_EMF_AUX_MUX
+    if ((ADMUX & 0x0F) == BACK_EMF_AUX_MUX) {
+        auxiliary = ADC;
+        ADMUX = (ADMUX & 0xF0) | BACK_EMF_MUX;
+        return;
+    }
+#endif
+    const uint16_t sample = ADC << 4;
+#ifdef BACK_EMF_AUX_MUX
+    ADMUX = (ADMUX & 0xF0) | BACK_EMF_AUX_MUX;
+    ADCSRA |= _BV(ADSC);
+#endif
+    uint16_t value = filtered;
+    if (primed) {
+        value += ((int16_t)(sample - value)) >> BACK_EMF_FILTER_SHIFT;
+    } else {
+        value = sample;
+        primed = true;
+    }
+    filtered = value;
+    const back_emf_handler_t callback = handler;
+    if (callback != NULL) {
+        callback(value >> 4);
+    }
+}
+
+void back_emf_initialize(void) {
+    ADMUX = _BV(REFS0) | BACK_EMF_MUX; // referencja AVcc = 5V
+    DIDR0 |= _BV(BACK_EMF_MUX);
+#ifdef BACK_EMF_AUX_MUX
+    DIDR0 |= _BV(BACK_EMF_AUX_MUX);
+#endif
+    // ADTS = 101 -- start od porównania Timer1 B
+    ADCSRB = _BV(ADTS2) | _BV(ADTS0);
+    // częstotliwość zegara ADC 250 kHz (16 MHz / 64), konwersja 52 µs
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1);
+
+    // ustaw tryb licznika
+    // COM1A = 10   -- non-inverting mode
+    // WGM1  = 1000 -- Phase and Frequency Correct PWM top=ICR1
+    // CS1   = 010  -- prescaler 8
+    // częstotliwość 16e6/(2*8*1023) = 977 Hz
+    ICR1 = BACK_EMF_TOP;
+    OCR1A = 0;
+    OCR1B = BACK_EMF_BLANKING_TICKS;
+    TCCR1A = _BV(COM1A1);
+    TCCR1B = _BV(WGM13) | _BV(CS11);
+    TIMSK1 |= _BV(TOIE1);
+    // ustaw pin OC1A (PB1) jako wyjście
+    DDRB |= _BV(PB1);
+    sei();
+}
+
+void back_emf_set_duty(uint16_t duty) {
+    if (duty > BACK_EMF_MAX_DUTY) {
+        duty = BACK_EMF_MAX_DUTY;
+    }
+    // OCR1A i OCR1B są buforowane do BOTTOM; zapisane razem przechodzą do
+    // tego samego okresu, więc moment pomiaru zawsze pasuje do wypełnienia
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        OCR1A = duty;
+        OCR1B = duty + BACK_EMF_BLANKING_TICKS;
+    }
+}
+
+void back_emf_set_handler(back_emf_handler_t callback) {
+    handler = callback;
+}
+
+uint16_t back_emf_speed(void) {
+    uint16_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        value = filtered;
+    }
+    return value >> 4;
+}
+
+uint16_t back_emf_auxiliary(void) {
+    uint16_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        value = auxiliary;
+    }
+    return value;
+}
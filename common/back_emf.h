@@ -0,0 +1,53 @@
+#ifndef __BACK_EMF_H
+#define __BACK_EMF_H
+
+#include <stdint.h>
+
+// PWM silnika z pomiarem siły przeciwelektromotorycznej (prędkości).
+//
+// Timer1 w trybie phase and frequency correct (TOP = ICR1 = BACK_EMF_TOP,
+// preskaler 8, ~977 Hz) steruje tranzystorem przez OC1A (PB1). Wyjście jest
+// niskie, gdy licznik jest powyżej OCR1A, więc środek przerwy w zasilaniu
+// wypada w TOP. ADC startuje sprzętowo od porównania OC1B, które
+// back_emf_set_duty() ustawia razem z OCR1A na wypełnienie plus
+// BACK_EMF_BLANKING_US, czyli tuż po wyłączeniu tranzystora, kiedy minie
+// szpilka z indukcyjności. Oba rejestry przechodzą z bufora w tym samym
+// BOTTOM. Przerwanie przepełnienia kasuje OCF1B, więc na okres przypada
+// dokładnie jeden pomiar. Żeby przerwa zawsze mieściła
+// wygaszanie, wypełnienie jest ograniczone do BACK_EMF_MAX_DUTY.
+//
+// Przerwanie ADC filtruje próbki (średnia wykładnicza, waga
+// 1/2^BACK_EMF_FILTER_SHIFT), publikuje wynik i woła opcjonalną funkcję
+// obsługi - regulator może więc działać w tempie PWM bez pętli głównej.
+// Przy zdefiniowanym BACK_EMF_AUX_MUX zaraz po pomiarze silnika to samo
+// przerwanie mierzy drugi kanał (np. potencjometr zadający prędkość).
+
+#define BACK_EMF_TOP 1023 // pełne wypełnienie
+
+#ifndef BACK_EMF_MUX
+#define BACK_EMF_MUX 1 // ADC1
+#endif
+
+#ifndef BACK_EMF_BLANKING_US
+#define BACK_EMF_BLANKING_US 50
+#endif
+
+#ifndef BACK_EMF_FILTER_SHIFT
+#define BACK_EMF_FILTER_SHIFT 2
+#endif
+
+// BACK_EMF_AUX_MUX -- opcjonalny drugi kanał ADC, mierzony raz na okres
+
+#define BACK_EMF_BLANKING_TICKS ((uint16_t)((BACK_EMF_BLANKING_US) * (F_CPU / 8 / 1000000UL)))
+#define BACK_EMF_MAX_DUTY (BACK_EMF_TOP - BACK_EMF_BLANKING_TICKS - 1)
+
+typedef void (*back_emf_handler_t)(uint16_t speed);
+
+void back_emf_initialize(void); /* Ustawia Timer1, ADC i PB1, włącza przerwania */
+void back_emf_set_duty(uint16_t duty); /* Wypełnienie 0..BACK_EMF_TOP, przycinane do BACK_EMF_MAX_DUTY */
+/* Funkcja wołana z przerwania ADC po każdym nowym oszacowaniu (NULL wyłącza) */
+void back_emf_set_handler(back_emf_handler_t handler);
+uint16_t back_emf_speed(void); /* Przefiltrowany pomiar 0..1023 (jednostki ADC) */
+uint16_t back_emf_auxiliary(void); /* Ostatni pomiar BACK_EMF_AUX_MUX */
+
+#endif
@@ -0,0 +1,111 @@
+#include "benchmark.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+static volatile uint16_t overflows = 0;
+
+ISR(TIMER1_OVF_vect) {
+    overflows++;
+}
+
+void benchmark_initialize(void) {
+    // ustaw tryb licznika
+    // WGM1  = 0000 -- normal
+    // CS1   = 001  -- prescaler 1
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    TIMSK1 = _BV(TOIE1);
+    sei();
+}
+
+uint32_t benchmark_now(void) {
+    const uint8_t sreg = SREG;
+    cli();
+    uint16_t low = TCNT1;
+    uint16_t high = overflows;
+    // Przepełnienie mogło nastąpić po wyłączeniu przerwań, a przed odczytem
+    // TCNT1 -- wtedy flaga TOV1 czeka, a licznik jest już mały.
+    if ((TIFR1 & _BV(TOV1)) && low < 0x8000) {
+        high++;
+    }
+    SREG = sreg;
+    return ((uint32_t)high << 16) | low;
+}
+
+static void empty(void) { }
+
+static uint32_t measure(void (*function)(void)) {
+    const uint32_t start_time = benchmark_now();
+    function();
+    const uint32_t end_time = benchmark_now();
+    return end_time - start_time;
+}
+
+static uint32_t overhead = 0;
+
+static void calibrate(uint8_t iterations) {
+    overhead = UINT32_MAX;
+    for (uint8_t iteration = 0; iteration < iterations; iteration++) {
+        const uint32_t time = measure(empty);
+        if (time < overhead) {
+            overhead = time;
+        }
+    }
+}
+
+static uint32_t samples[BENCHMARK_MAX_ITERATIONS];
+
+// sortowanie przez wstawianie -- próbek jest kilkadziesiąt
+static void sort_samples(uint8_t count) {
+    for (uint8_t index = 1; index < count; index++) {
+        const uint32_t sample = samples[index];
+        uint8_t position = index;
+        while (position > 0 && samples[position - 1] > sample) {
+            samples[position] = samples[position - 1];
+            position--;
+        }
+        samples[position] = sample;
+    }
+}
+
+void benchmark_run(const benchmark_t* benchmark, uint8_t iterations, benchmark_result_t* result) {
+    if (iterations > BENCHMARK_MAX_ITERATIONS) {
+        iterations = BENCHMARK_MAX_ITERATIONS;
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    for (uint8_t iteration = 0; iteration < iterations; iteration++) {
+        const uint32_t time = measure(benchmark->function);
+        samples[iteration] = time > overhead ? time - overhead : 0;
+    }
+
+    sort_samples(iterations);
+    result->min = samples[0];
+    result->median = samples[iterations / 2];
+    result->max = samples[iterations - 1];
+}
+
+void benchmark_run_all(const benchmark_t* benchmarks, uint8_t count, uint8_t iterations) {
+    calibrate(iterations);
+    printf("# overhead,%" PRIu32 "\r\n", overhead);
+    printf("# benchmark,iterations,min,median,max\r\n");
+    for (uint8_t index = 0; index < count; index++) {
+        benchmark_result_t result;
+        benchmark_run(&benchmarks[index], iterations, &result);
+        fputs_P(benchmarks[index].name, stdout);
+        printf(",%u,%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\r\n", iterations, result.min, result.median, result.max);
+    }
+}
+
+void benchmark_halt(void) {
+    cli();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_cpu();
+}
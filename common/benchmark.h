@@ -0,0 +1,51 @@
+#ifndef __BENCHMARK_H
+#define __BENCHMARK_H
+
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+// Pomiar liczby cykli procesora dla krótkich fragmentów kodu.
+//
+// Timer1 liczy z preskalerem 1, a przepełnienia są zliczane w przerwaniu,
+// więc pojedynczy pomiar ma 32 bity (do ~268 s przy 16 MHz). Każdy
+// benchmark jest wywoływany przez wskaźnik iterations razy; od każdego
+// pomiaru odejmowany jest narzut samego pomiaru (wywołanie pustej funkcji
+// i dwa odczyty licznika), wyznaczony na starcie jako minimum z
+// iterations prób. Wynik to tabela CSV na stdout:
+//     # benchmark,iterations,min,median,max
+//     add_int16_t,32,3,3,3
+//
+// Definiowanie:
+//     BENCHMARK(add_int16_t) { volatile int16_t _ = left + right; }
+//     const benchmark_t benchmarks[] = { BENCHMARK_ENTRY(add_int16_t), ... };
+//
+// Po benchmark_run_all procesor można zatrzymać przez benchmark_halt(),
+// wtedy ten sam plik .elf uruchomiony w simavr (make simulate) kończy się
+// sam po wypisaniu tabeli.
+
+#define BENCHMARK_MAX_ITERATIONS 64
+
+typedef struct {
+    const char* name; // w pamięci programu
+    void (*function)(void);
+} benchmark_t;
+
+#define BENCHMARK(id)                                        \
+    static const char benchmark_##id##_name[] PROGMEM = #id; \
+    static void benchmark_##id(void)
+
+#define BENCHMARK_ENTRY(id) { benchmark_##id##_name, benchmark_##id }
+
+typedef struct {
+    uint32_t min;
+    uint32_t median;
+    uint32_t max;
+} benchmark_result_t;
+
+void benchmark_initialize(void);                  /* Uruchamia Timer1 i włącza przerwania */
+uint32_t benchmark_now(void);                     /* 32-bitowy licznik cykli */
+void benchmark_run(const benchmark_t* benchmark, uint8_t iterations, benchmark_result_t* result);
+void benchmark_run_all(const benchmark_t* benchmarks, uint8_t count, uint8_t iterations); /* Wypisuje tabelę */
+void benchmark_halt(void);                        /* cli + sleep, kończy symulację */
+
+#endif
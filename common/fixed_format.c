@@ -0,0 +1,92 @@
+#include "fixed_format.h"
+#include <stddef.h>
+#include <stdint.h>
+
+static const uint32_t powers_of_ten[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+#define MAX_DECIMALS 9
+
+// Wypisuje cyfry od końca do tymczasowego bufora i kopiuje je do wyniku,
+// pilnując rozmiaru jak snprintf.
+static int emit(char* buffer, size_t size, uint8_t negative, uint32_t integer, uint32_t fraction,
+                uint8_t decimals) {
+    char digits[1 + 10 + 1 + MAX_DECIMALS];
+    uint8_t length = 0;
+
+    for (uint8_t index = 0; index < decimals; index++) {
+        digits[length++] = '0' + fraction % 10;
+        fraction /= 10;
+    }
+    if (decimals > 0) {
+        digits[length++] = '.';
+    }
+    do {
+        digits[length++] = '0' + integer % 10;
+        integer /= 10;
+    } while (integer != 0);
+    if (negative) {
+        digits[length++] = '-';
+    }
+
+    if (size > 0) {
+        const size_t copied = length < size - 1 ? length : size - 1;
+        for (size_t index = 0; index < copied; index++) {
+            buffer[index] = digits[length - 1 - index];
+        }
+        buffer[copied] = '\0';
+    }
+    return length;
+}
+
+int format_fixed(char* buffer, size_t size, int32_t value, uint8_t scale, uint8_t decimals) {
+    if (scale > MAX_DECIMALS) {
+        scale = MAX_DECIMALS;
+    }
+    if (decimals > MAX_DECIMALS) {
+        decimals = MAX_DECIMALS;
+    }
+
+    const uint8_t negative = value < 0;
+    uint32_t magnitude = negative ? -(uint32_t)value : (uint32_t)value;
+
+    uint32_t integer = magnitude / powers_of_ten[scale];
+    uint32_t fraction = magnitude % powers_of_ten[scale];
+    if (decimals < scale) {
+        // zaokrąglij odcinane cyfry
+        const uint32_t divisor = powers_of_ten[scale - decimals];
+        fraction = (fraction + divisor / 2) / divisor;
+        if (fraction >= powers_of_ten[decimals]) {
+            fraction -= powers_of_ten[decimals];
+            integer++;
+        }
+    } else {
+        fraction *= powers_of_ten[decimals - scale];
+    }
+
+    return emit(buffer, size, negative && (integer != 0 || fraction != 0), integer, fraction, decimals);
+}
+
+int format_q(char* buffer, size_t size, int32_t value, uint8_t fraction_bits, uint8_t decimals) {
+    if (decimals > MAX_DECIMALS) {
+        decimals = MAX_DECIMALS;
+    }
+
+    const uint8_t negative = value < 0;
+    const uint32_t magnitude = negative ? -(uint32_t)value : (uint32_t)value;
+    const uint32_t mask = ((uint32_t)1 << fraction_bits) - 1;
+
+    uint32_t integer = magnitude >> fraction_bits;
+    // Część ułamkowa * 10^decimals w 64 bitach, bo fraction_bits + log2(10^9)
+    // nie mieści się w 32. Dla typowych Q8/Q16 i 2-3 cyfr wystarczyłoby 32,
+    // ale to i tak jest wołane raz na wypisanie liczby.
+    const uint64_t scaled = (uint64_t)(magnitude & mask) * powers_of_ten[decimals];
+    uint32_t fraction = (scaled + ((uint64_t)1 << fraction_bits >> 1)) >> fraction_bits;
+    if (fraction >= powers_of_ten[decimals]) {
+        fraction -= powers_of_ten[decimals];
+        integer++;
+    }
+
+    return emit(buffer, size, negative && (integer != 0 || fraction != 0), integer, fraction, decimals);
+}
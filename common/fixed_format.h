@@ -0,0 +1,27 @@
+#ifndef __FIXED_FORMAT_H
+#define __FIXED_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Formatowanie liczb stałoprzecinkowych bez vfprintf z obsługą float
+// (-lprintf_flt) i bez libm.
+//
+// Obie funkcje działają jak snprintf: wpisują co najwyżej size - 1 znaków
+// i zawsze kończą wynik zerem (o ile size > 0), a zwracają długość, jaką
+// miałby pełny napis. Wynik jest zaokrąglany do najbliższej wartości
+// (połówki od zera), np.:
+//     format_fixed(buffer, sizeof(buffer), 1234, 3, 2)  -> "1.23"  (mV jako V)
+//     format_fixed(buffer, sizeof(buffer), -215, 1, 1)  -> "-21.5" (d°C jako °C)
+//     format_q(buffer, sizeof(buffer), 0x0180, 8, 2)    -> "1.50"  (Q8.8)
+
+/* value to liczba w jednostkach 10^-scale; wypisuje decimals cyfr po przecinku */
+int format_fixed(char* buffer, size_t size, int32_t value, uint8_t scale, uint8_t decimals);
+/* value w formacie Q z fraction_bits bitami ułamka; wypisuje decimals cyfr po przecinku */
+int format_q(char* buffer, size_t size, int32_t value, uint8_t fraction_bits, uint8_t decimals);
+
+#define format_milivolts(buffer, size, milivolts, decimals) format_fixed((buffer), (size), (milivolts), 3, (decimals))
+#define format_decycelsius(buffer, size, decycelsius) format_fixed((buffer), (size), (decycelsius), 1, 1)
+#define format_centidecibels(buffer, size, centidecibels) format_fixed((buffer), (size), (centidecibels), 2, 2)
+
+#endif
@@ -0,0 +1,62 @@
+#include "fixed_math.h"
+#include <stdint.h>
+
+uint16_t fixed_sqrt32(uint32_t value) {
+    // metoda cyfra po cyfrze (po dwa bity)
+    uint32_t result = 0;
+    uint32_t bit = (uint32_t)1 << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+int32_t fixed_log2_q16(uint32_t value) {
+    // log2(0) = -nieskończoność; bez tego pętla poniżej nigdy się nie kończy
+    if (value == 0) {
+        return INT32_MIN;
+    }
+
+    // część całkowita to pozycja najstarszego bitu
+    int8_t integer = 31;
+    while (!(value & ((uint32_t)1 << 31))) {
+        value <<= 1;
+        integer--;
+    }
+
+    // mantysa w [1, 2) jako Q15; każde podniesienie do kwadratu daje
+    // kolejny bit części ułamkowej
+    uint16_t mantissa = value >> 16;
+    int32_t result = (int32_t)integer << 16;
+    for (uint32_t bit = (uint32_t)1 << 15; bit != 0; bit >>= 1) {
+        const uint32_t square = ((uint32_t)mantissa * mantissa) >> 15;
+        if (square >= ((uint32_t)1 << 16)) {
+            mantissa = square >> 1;
+            result += bit;
+        } else {
+            mantissa = square;
+        }
+    }
+    return result;
+}
+
+int16_t fixed_centidecibels(uint32_t value, uint32_t reference) {
+    if (value == 0) {
+        return FIXED_CENTIDECIBELS_MIN;
+    }
+    if (reference == 0) {
+        return INT16_MAX;
+    }
+    // 20 * log10(x) * 100 = 2000 * log10(2) * log2(x) = 602.06 * log2(x)
+    const int32_t log2_ratio = fixed_log2_q16(value) - fixed_log2_q16(reference);
+    return (log2_ratio * 301 + ((int32_t)1 << 14)) >> 15;
+}
@@ -0,0 +1,19 @@
+#ifndef __FIXED_MATH_H
+#define __FIXED_MATH_H
+
+#include <stdint.h>
+
+// Całkowitoliczbowe zamienniki sqrt() i log10() z libm.
+
+/* Pierwiastek całkowity (podłoga) */
+uint16_t fixed_sqrt32(uint32_t value);
+/* Wynik fixed_centidecibels() dla value == 0 (-nieskończoność) */
+#define FIXED_CENTIDECIBELS_MIN INT16_MIN
+
+/* log2(value) w formacie Q16.16; dla value == 0 zwraca INT32_MIN */
+int32_t fixed_log2_q16(uint32_t value);
+/* 20 * log10(value / reference) w setnych częściach decybela;
+   dla value == 0 zwraca FIXED_CENTIDECIBELS_MIN */
+int16_t fixed_centidecibels(uint32_t value, uint32_t reference);
+
+#endif
@@ -0,0 +1,235 @@
+#include "frequency_meter.h"
+#include "fixed_math.h"
+#include "ring_buffer.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+typedef struct {
+    uint32_t period;
+    uint32_t high; // 0 gdy zbocze opadające przepadło
+} cycle_t;
+
+RING_BUFFER_CREATE(cycles, cycle_t, 16);
+
+// czas bramki w cyklach procesora, do kończenia uśredniania w trybie odwrotnym
+#define GATE_CYCLES ((uint64_t)F_CPU / 1000 * FREQUENCY_METER_GATE_MS)
+
+static volatile frequency_meter_mode_t mode;
+static volatile uint16_t overflows = 0;
+static volatile uint8_t overruns = 0;
+
+// tryb odwrotny
+static volatile bool too_fast = false;
+static uint32_t last_rising;
+static uint32_t last_falling;
+static bool has_rising;
+static bool has_falling;
+
+// tryb bramkowany
+static uint16_t gate_milliseconds;
+static uint32_t gate_start;
+static volatile uint32_t gated_edges;
+static volatile bool gate_ready = false;
+
+// 32-bitowy licznik Timer1; wołać przy zablokowanych przerwaniach
+static inline uint32_t extend(uint16_t low) {
+    uint16_t high = overflows;
+    // przepełnienie czeka w TOV1, a licznik już się przekręcił
+    if ((TIFR1 & _BV(TOV1)) && low < 0x8000) {
+        high++;
+    }
+    return ((uint32_t)high << 16) | low;
+}
+
+ISR(TIMER1_OVF_vect) {
+    overflows++;
+}
+
+ISR(TIMER1_CAPT_vect) {
+    const uint32_t timestamp = extend(ICR1);
+    if (TCCR1B & _BV(ICES1)) {
+        // zbocze narastające: następne łapiemy opadające
+        TCCR1B &= ~_BV(ICES1);
+        TIFR1 = _BV(ICF1); // zmiana ICES1 może ustawić ICF1
+        if (has_rising) {
+            const uint32_t period = timestamp - last_rising;
+            if (period < FREQUENCY_METER_MIN_PERIOD) {
+                // za szybko na przerwanie na zbocze; przełączy pętla główna
+                TIMSK1 &= ~_BV(ICIE1);
+                too_fast = true;
+                return;
+            }
+            const cycle_t cycle = { period, has_falling ? last_falling - last_rising : 0 };
+            if (!cycles_write(cycle) && overruns != UINT8_MAX) {
+                overruns++;
+            }
+        }
+        last_rising = timestamp;
+        has_rising = true;
+        has_falling = false;
+    } else {
+        TCCR1B |= _BV(ICES1);
+        TIFR1 = _BV(ICF1);
+        last_falling = timestamp;
+        has_falling = has_rising;
+    }
+}
+
+ISR(TIMER0_COMPA_vect) {
+    if (++gate_milliseconds < FREQUENCY_METER_GATE_MS) {
+        return;
+    }
+    gate_milliseconds = 0;
+    const uint32_t count = extend(TCNT1);
+    gated_edges = count - gate_start;
+    gate_start = count;
+    gate_ready = true;
+}
+
+static void start_reciprocal(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // zatrzymaj bramkę
+        TIMSK0 = 0;
+        TCCR0B = 0;
+        // ustaw tryb licznika
+        // WGM1  = 0000 -- normal
+        // CS1   = 001  -- prescaler 1
+        // ICES1 = 1    -- capture na zboczu narastającym
+        // ICNC1 = 1    -- filtr szumów (4 próbki)
+        TCCR1A = 0;
+        TCCR1B = _BV(ICNC1) | _BV(ICES1) | _BV(CS10);
+        TCNT1 = 0;
+        overflows = 0;
+        has_rising = false;
+        has_falling = false;
+        too_fast = false;
+        cycles_clear();
+        TIFR1 = _BV(ICF1) | _BV(TOV1);
+        TIMSK1 = _BV(ICIE1) | _BV(TOIE1);
+        mode = FREQUENCY_METER_RECIPROCAL;
+    }
+}
+
+static void start_gated(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // ustaw tryb licznika
+        // WGM1  = 0000 -- normal
+        // CS1   = 111  -- zegar zewnętrzny z T1, zbocze narastające
+        TCCR1A = 0;
+        TCCR1B = _BV(CS12) | _BV(CS11) | _BV(CS10);
+        TCNT1 = 0;
+        overflows = 0;
+        TIFR1 = _BV(ICF1) | _BV(TOV1);
+        TIMSK1 = _BV(TOIE1);
+        gate_start = 0;
+        gate_milliseconds = 0;
+        gate_ready = false;
+        // bramka: Timer0
+        // WGM0  = 010 -- CTC
+        // CS0   = 011 -- prescaler 64
+        // OCR0A = 249 -- 16e6 / (64 * 250) = 1 kHz
+        TCCR0A = _BV(WGM01);
+        OCR0A = 249;
+        TCNT0 = 0;
+        TCCR0B = _BV(CS01) | _BV(CS00);
+        TIMSK0 = _BV(OCIE0A);
+        mode = FREQUENCY_METER_GATED;
+    }
+}
+
+void frequency_meter_initialize(void) {
+    DDRB &= ~_BV(PB0); // ICP1
+    DDRD &= ~_BV(PD5); // T1
+    start_reciprocal();
+    sei();
+}
+
+// akumulatory trybu odwrotnego; odchylenia liczone od pierwszego okresu
+static uint32_t periods = 0;
+static uint32_t first_period;
+static uint64_t total_time;
+static uint64_t total_high;
+static int64_t deviations;
+static uint64_t squared_deviations;
+
+static void reset_accumulators(void) {
+    periods = 0;
+    total_time = 0;
+    total_high = 0;
+    deviations = 0;
+    squared_deviations = 0;
+}
+
+static uint8_t take_overruns(void) {
+    uint8_t result;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        result = overruns;
+        overruns = 0;
+    }
+    return result;
+}
+
+static bool update_reciprocal(frequency_meter_result_t* result) {
+    if (too_fast) {
+        reset_accumulators();
+        start_gated();
+        return false;
+    }
+    cycle_t cycle;
+    while (cycles_read(&cycle)) {
+        if (periods == 0) {
+            first_period = cycle.period;
+        }
+        const int32_t deviation = cycle.period - first_period;
+        periods++;
+        total_time += cycle.period;
+        total_high += cycle.high;
+        deviations += deviation;
+        squared_deviations += (uint64_t)((int64_t)deviation * deviation);
+    }
+    if (periods < 2 || total_time < GATE_CYCLES) {
+        return false;
+    }
+
+    result->mode = FREQUENCY_METER_RECIPROCAL;
+    result->frequency_centihertz = (uint64_t)F_CPU * 100 * periods / total_time;
+    result->period_cycles = total_time / periods;
+    result->duty_permille = total_high * 1000 / total_time;
+    const uint64_t m2 = squared_deviations - (uint64_t)(deviations * deviations) / periods;
+    const uint64_t variance = m2 / periods;
+    result->jitter_cycles = fixed_sqrt32(variance > UINT32_MAX ? UINT32_MAX : variance);
+    result->count = periods;
+    result->overruns = take_overruns();
+    reset_accumulators();
+    return true;
+}
+
+static bool update_gated(frequency_meter_result_t* result) {
+    uint32_t edges;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (!gate_ready) {
+            return false;
+        }
+        gate_ready = false;
+        edges = gated_edges;
+    }
+    result->mode = FREQUENCY_METER_GATED;
+    result->frequency_centihertz = (uint64_t)edges * 100 * 1000 / FREQUENCY_METER_GATE_MS;
+    result->period_cycles = 0;
+    result->duty_permille = 0;
+    result->jitter_cycles = 0;
+    result->count = edges;
+    result->overruns = 0;
+    if (result->frequency_centihertz < (uint32_t)FREQUENCY_METER_SWITCH_DOWN_HZ * 100) {
+        start_reciprocal();
+    }
+    return true;
+}
+
+bool frequency_meter_update(frequency_meter_result_t* result) {
+    if (mode == FREQUENCY_METER_RECIPROCAL) {
+        return update_reciprocal(result);
+    }
+    return update_gated(result);
+}
@@ -0,0 +1,63 @@
+#ifndef __FREQUENCY_METER_H
+#define __FREQUENCY_METER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pomiar częstotliwości, okresu, wypełnienia i jittera sygnału prostokątnego
+// na Timer1 (i Timer0 jako bramce).
+//
+// Tryb odwrotny (niskie częstotliwości): Timer1 liczy cykle procesora,
+// a input capture (ICP1 = PB0) zapisuje czas każdego zbocza. Przepełnienia
+// rozszerzają czas do 32 bitów, więc okres może mieć do ~268 s, a
+// rozdzielczość to jeden cykl (62.5 ns). Zbocza są łapane na zmianę
+// narastające i opadające, co daje też czas stanu wysokiego. Okresy trafiają
+// do bufora cyklicznego, z którego frequency_meter_update() liczy średnią,
+// wypełnienie i odchylenie standardowe okresu (jitter).
+//
+// Tryb bramkowany (wysokie częstotliwości): Timer1 jest taktowany z pinu
+// T1 = PD5, a Timer0 co 1 ms odlicza czas bramki i odczytuje licznik. Nie ma
+// tu przerwania na zbocze, więc mierzymy do ~F_CPU / 2.5 (6.4 MHz), ale tylko
+// częstotliwość, z rozdzielczością 1 / FREQUENCY_METER_GATE_MS.
+//
+// Przełączanie jest automatyczne: okres krótszy niż
+// FREQUENCY_METER_MIN_PERIOD cykli w trybie odwrotnym przełącza na bramkowany
+// (zanim przerwania na każde zbocze zagłodzą procesor), a wynik bramkowany
+// poniżej FREQUENCY_METER_SWITCH_DOWN_HZ wraca do odwrotnego. Sygnał musi być
+// więc podłączony do obu pinów: PB0 i PD5.
+//
+// Wynik pojawia się mniej więcej co FREQUENCY_METER_GATE_MS (w trybie
+// odwrotnym po co najmniej dwóch pełnych okresach).
+
+#ifndef FREQUENCY_METER_GATE_MS
+#define FREQUENCY_METER_GATE_MS 1000
+#endif
+
+#ifndef FREQUENCY_METER_MIN_PERIOD
+#define FREQUENCY_METER_MIN_PERIOD 1600 // 10 kHz przy 16 MHz
+#endif
+
+#ifndef FREQUENCY_METER_SWITCH_DOWN_HZ
+#define FREQUENCY_METER_SWITCH_DOWN_HZ 5000
+#endif
+
+typedef enum {
+    FREQUENCY_METER_RECIPROCAL = 0,
+    FREQUENCY_METER_GATED = 1,
+} frequency_meter_mode_t;
+
+typedef struct {
+    frequency_meter_mode_t mode;
+    uint32_t frequency_centihertz;
+    uint32_t period_cycles; // średni okres; 0 w trybie bramkowanym
+    uint16_t duty_permille; // 0 w trybie bramkowanym
+    uint32_t jitter_cycles; // odchylenie standardowe okresu; 0 w trybie bramkowanym
+    uint32_t count; // liczba uśrednionych okresów albo zliczonych zboczy
+    uint8_t overruns; // okresy zgubione przy pełnym buforze
+} frequency_meter_result_t;
+
+void frequency_meter_initialize(void); /* Start w trybie odwrotnym, włącza przerwania */
+/* Wołane w pętli głównej; true, gdy w result jest nowy pomiar */
+bool frequency_meter_update(frequency_meter_result_t* result);
+
+#endif
@@ -0,0 +1,155 @@
+#include "ir_proximity.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#define DETECTOR PB0
+#define DETECTOR_PIN PINB
+#define DETECTOR_PORT PORTB
+
+// Każda paczka to PAIR_SLOTS szczelin:
+//  0   -- nośna włączona, okno sygnału
+//  1   -- nośna wyłączona, nadal okno sygnału: odbiornik włącza wyjście
+//         7-15 okresów nośnej po początku paczki i tyle samo trzyma je po
+//         jej końcu, więc odpowiedź przesuwa się o 200-400 µs
+//  2-3 -- okno tła tej samej długości, już po ogonie odpowiedzi
+// Po IR_PROXIMITY_BURSTS paczkach następuje przerwa.
+#define PAIR_SLOTS 4
+#define ACTIVE_SLOTS (PAIR_SLOTS * IR_PROXIMITY_BURSTS)
+#define FRAME_SLOTS (ACTIVE_SLOTS + IR_PROXIMITY_IDLE_SLOTS)
+
+static uint8_t slot = 0;
+static bool low = false;
+static uint8_t low_since;
+static uint8_t low_ticks; // w bieżącej szczelinie
+
+static uint16_t signal;
+static uint16_t ambient;
+
+static volatile bool ready = false;
+static volatile uint16_t ready_signal;
+static volatile uint16_t ready_ambient;
+
+static inline void carrier_on(void) {
+    TCCR1A |= _BV(COM1A1);
+}
+
+static inline void carrier_off(void) {
+    TCCR1A &= ~_BV(COM1A1);
+    PORTB &= ~_BV(PB1); // po odłączeniu OC1A pin ma stan z PORTB
+}
+
+ISR(PCINT0_vect) {
+    const bool now_low = !(DETECTOR_PIN & _BV(DETECTOR));
+    if (now_low == low) {
+        return; // zmiana na innym pinie portu B
+    }
+    uint8_t now = TCNT2;
+    // PCINT0 ma wyższy priorytet niż TIMER2_COMPA: jeśli TCNT2 już się
+    // wyzerował, a szczelina nie została zamknięta, zbocze liczymy na jej
+    // koniec (TCNT2 czytany przed flagą, więc mała wartość zawsze ma flagę)
+    if (TIFR2 & _BV(OCF2A)) {
+        now = IR_PROXIMITY_SLOT_TICKS;
+    }
+    if (now_low) {
+        low_since = now;
+    } else {
+        low_ticks += now - low_since;
+    }
+    low = now_low;
+}
+
+ISR(TIMER2_COMPA_vect) {
+    // zamknij szczelinę: stan niski trwający do końca też się liczy
+    uint8_t ticks = low_ticks;
+    if (low) {
+        ticks += IR_PROXIMITY_SLOT_TICKS - low_since;
+        low_since = 0;
+    }
+    low_ticks = 0;
+
+    if (slot < ACTIVE_SLOTS) {
+        if ((slot & (PAIR_SLOTS - 1)) < 2) {
+            signal += ticks;
+        } else {
+            ambient += ticks;
+        }
+    }
+
+    if (++slot == FRAME_SLOTS) {
+        slot = 0;
+        ready_signal = signal;
+        ready_ambient = ambient;
+        ready = true;
+        signal = 0;
+        ambient = 0;
+    }
+    // nośna tylko w pierwszej szczelinie każdej paczki
+    if (slot < ACTIVE_SLOTS && (slot & (PAIR_SLOTS - 1)) == 0) {
+        carrier_on();
+    } else {
+        carrier_off();
+    }
+}
+
+void ir_proximity_initialize(void) {
+    // nośna: Timer1
+    // COM1A = 00   -- odłączone do pierwszej szczeliny sygnału
+    // WGM1  = 1110 -- fast PWM top=ICR1
+    // CS1   = 001  -- prescaler 1
+    // częstotliwość 16e6/(1+421) = 37.9 kHz, wypełnienie 50%
+    ICR1 = 421;
+    OCR1A = 421 / 2;
+    TCCR1A = _BV(WGM11);
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS10);
+    PORTB &= ~_BV(PB1);
+    DDRB |= _BV(PB1);
+
+    // odbiornik na PB0 z pull-upem, przerwanie PCINT0
+    DDRB &= ~_BV(DETECTOR);
+    DETECTOR_PORT |= _BV(DETECTOR);
+    low = !(DETECTOR_PIN & _BV(DETECTOR));
+    low_since = 0;
+    PCMSK0 |= _BV(PCINT0);
+    PCIFR = _BV(PCIF0);
+    PCICR |= _BV(PCIE0);
+
+    // szczeliny: Timer2
+    // WGM2  = 010 -- CTC
+    // CS2   = 100 -- prescaler 64, takt 4 µs
+    // OCR2A = 149 -- 150 taktów = 600 µs
+    TCCR2A = _BV(WGM21);
+    OCR2A = IR_PROXIMITY_SLOT_TICKS - 1;
+    TCNT2 = 0;
+    TCCR2B = _BV(CS22);
+    TIMSK2 = _BV(OCIE2A);
+
+    slot = 0;
+    carrier_on();
+    sei();
+}
+
+bool ir_proximity_update(ir_proximity_result_t* result) {
+    static bool detected = false;
+    uint16_t frame_signal;
+    uint16_t frame_ambient;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (!ready) {
+            return false;
+        }
+        ready = false;
+        frame_signal = ready_signal;
+        frame_ambient = ready_ambient;
+    }
+    const int16_t score = (int16_t)frame_signal - (int16_t)frame_ambient;
+    if (score >= IR_PROXIMITY_ON_THRESHOLD) {
+        detected = true;
+    } else if (score <= IR_PROXIMITY_OFF_THRESHOLD) {
+        detected = false;
+    }
+    result->signal = frame_signal;
+    result->ambient = frame_ambient;
+    result->score = score;
+    result->detected = detected;
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef __IR_PROXIMITY_H
+#define __IR_PROXIMITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Czujnik zbliżeniowy na podczerwień z detekcją synchroniczną.
+//
+// Timer1 generuje nośną 38 kHz na OC1A (PB1, dioda IR), a Timer2 w trybie
+// CTC dzieli czas na szczeliny po 600 µs. Paczka nośnej trwa jedną
+// szczelinę; okno sygnału to ta szczelina i następna (odbiornik odpowiada
+// z opóźnieniem 200-400 µs i tyle samo trzyma wyjście po końcu paczki),
+// a okno tła to kolejne dwie szczeliny bez nośnej. Po IR_PROXIMITY_BURSTS
+// paczkach następuje przerwa IR_PROXIMITY_IDLE_SLOTS szczelin, żeby AGC
+// odbiornika się nie przestawiło.
+//
+// Wyjście odbiornika (aktywne niskie) na PB0 obsługuje przerwanie PCINT0:
+// każda zmiana stanu dolicza czas stanu niskiego do bieżącej szczeliny.
+// Wynik ramki to suma (niski w oknie sygnału - niski w oknie tła) w taktach
+// Timer2 (4 µs), więc światło otoczenia i zakłócenia, które obniżają
+// wyjście niezależnie od nośnej, się odejmują. Decyzja ma histerezę między
+// IR_PROXIMITY_OFF_THRESHOLD a IR_PROXIMITY_ON_THRESHOLD.
+//
+// Procesor nie czeka na nic; ramka (domyślnie 100 ms) kończy się ustawieniem
+// wyniku, który odbiera ir_proximity_update().
+
+#ifndef IR_PROXIMITY_BURSTS
+#define IR_PROXIMITY_BURSTS 6
+#endif
+
+#ifndef IR_PROXIMITY_IDLE_SLOTS
+#define IR_PROXIMITY_IDLE_SLOTS 143 // do 100 ms na ramkę
+#endif
+
+// Wyraźne odbicie daje na paczkę ~150 taktów (długość paczki, ±40 od
+// zniekształcenia szerokości impulsu w odbiorniku). Próg włączenia to ok.
+// 1/3 najgorszego przypadku, więc wystarcza też część paczek.
+#ifndef IR_PROXIMITY_ON_THRESHOLD
+#define IR_PROXIMITY_ON_THRESHOLD (IR_PROXIMITY_BURSTS * 40)
+#endif
+
+#ifndef IR_PROXIMITY_OFF_THRESHOLD
+#define IR_PROXIMITY_OFF_THRESHOLD (IR_PROXIMITY_BURSTS * 20)
+#endif
+
+#define IR_PROXIMITY_SLOT_TICKS 150 // 600 µs w taktach 4 µs
+
+typedef struct {
+    uint16_t signal; // czas stanu niskiego w oknach sygnału
+    uint16_t ambient; // czas stanu niskiego w oknach tła
+    int16_t score; // signal - ambient
+    bool detected;
+} ir_proximity_result_t;
+
+void ir_proximity_initialize(void); /* Ustawia Timer1, Timer2 i PCINT0, włącza przerwania */
+/* Wołane w pętli głównej; true, gdy w result jest wynik nowej ramki */
+bool ir_proximity_update(ir_proximity_result_t* result);
+
+#endif
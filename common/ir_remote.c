@@ -0,0 +1,231 @@
+#include "ir_remote.h"
+#include "ring_buffer.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+#define GAP 0x7FFF // stan dłuższy niż przepełnienie licznika
+
+typedef struct {
+    uint16_t microseconds : 15;
+    uint16_t mark : 1; // 1 = impuls (nośna, wyjście odbiornika niskie)
+} edge_t;
+
+RING_BUFFER_CREATE(edges, edge_t, 128);
+RING_BUFFER_CREATE(keys, ir_remote_key_t, 8);
+
+static uint16_t last_capture;
+static volatile uint8_t overflows = 2;
+
+ISR(TIMER1_CAPT_vect) {
+    const uint16_t capture = ICR1;
+    // ICES1 = 0: złapaliśmy zbocze opadające, czyli skończyła się przerwa
+    const bool mark = TCCR1B & _BV(ICES1);
+    TCCR1B ^= _BV(ICES1);
+    TIFR1 = _BV(ICF1); // zmiana ICES1 może ustawić ICF1
+    uint16_t microseconds = (capture - last_capture) >> 1;
+    // od poprzedniego zbocza minął cały okres licznika (32.8 ms)
+    if (overflows > 1 || (overflows == 1 && capture >= last_capture)) {
+        microseconds = GAP;
+    }
+    overflows = 0;
+    last_capture = capture;
+    const edge_t edge = { microseconds, mark };
+    edges_write(edge);
+}
+
+ISR(TIMER1_OVF_vect) {
+    if (overflows < 2) {
+        overflows++;
+    }
+}
+
+void ir_remote_initialize(void) {
+    DDRB &= ~_BV(PB0);
+    PORTB |= _BV(PB0);
+    // ustaw tryb licznika
+    // WGM1  = 0000 -- normal
+    // CS1   = 010  -- prescaler 8, 0.5 µs
+    // ICES1 = 0    -- capture na zboczu opadającym (początek impulsu)
+    // ICNC1 = 1    -- filtr szumów (4 próbki)
+    TCCR1A = 0;
+    TCCR1B = _BV(ICNC1) | _BV(CS11);
+    TCNT1 = 0;
+    last_capture = 0;
+    overflows = 2;
+    TIFR1 = _BV(ICF1) | _BV(TOV1);
+    TIMSK1 = _BV(ICIE1) | _BV(TOIE1);
+    sei();
+}
+
+// czas w granicach ±25% od nominalnego
+static inline bool near(uint16_t microseconds, uint16_t nominal) {
+    return microseconds > nominal - nominal / 4 && microseconds < nominal + nominal / 4;
+}
+
+static void push_key(ir_remote_protocol_t protocol, uint16_t address, uint8_t command, bool repeat) {
+    const ir_remote_key_t key = { protocol, address, command, repeat };
+    keys_write(key);
+}
+
+// NEC
+
+typedef enum {
+    NEC_IDLE,
+    NEC_LEADER_SPACE,
+    NEC_BIT_MARK,
+    NEC_BIT_SPACE,
+    NEC_REPEAT_MARK,
+} nec_state_t;
+
+static nec_state_t nec_state = NEC_IDLE;
+static uint32_t nec_bits;
+static uint8_t nec_count;
+static bool nec_valid = false; // czy jest co powtarzać
+static uint16_t nec_address;
+static uint8_t nec_command;
+
+static void nec_frame(void) {
+    const uint8_t address = nec_bits;
+    const uint8_t inverted_address = nec_bits >> 8;
+    const uint8_t command = nec_bits >> 16;
+    const uint8_t inverted_command = nec_bits >> 24;
+    if ((uint8_t)(command ^ inverted_command) != 0xFF) {
+        nec_valid = false;
+        return;
+    }
+    // rozszerzony NEC: 16-bitowy adres bez negacji
+    nec_address = (uint8_t)(address ^ inverted_address) == 0xFF ? address : (uint16_t)nec_bits;
+    nec_command = command;
+    nec_valid = true;
+    push_key(IR_REMOTE_NEC, nec_address, nec_command, false);
+}
+
+static void nec_edge(edge_t edge) {
+    switch (nec_state) {
+    case NEC_IDLE:
+        if (edge.mark && near(edge.microseconds, 9000)) {
+            nec_state = NEC_LEADER_SPACE;
+        }
+        return;
+    case NEC_LEADER_SPACE:
+        if (!edge.mark && near(edge.microseconds, 4500)) {
+            nec_bits = 0;
+            nec_count = 0;
+            nec_state = NEC_BIT_MARK;
+            return;
+        }
+        if (!edge.mark && near(edge.microseconds, 2250)) {
+            nec_state = NEC_REPEAT_MARK;
+            return;
+        }
+        break;
+    case NEC_BIT_MARK:
+        if (edge.mark && near(edge.microseconds, 560)) {
+            if (nec_count == 32) {
+                nec_frame();
+                nec_state = NEC_IDLE;
+            } else {
+                nec_state = NEC_BIT_SPACE;
+            }
+            return;
+        }
+        break;
+    case NEC_BIT_SPACE:
+        if (!edge.mark && (near(edge.microseconds, 560) || near(edge.microseconds, 1690))) {
+            // bity od najmłodszego
+            nec_bits >>= 1;
+            if (edge.microseconds > 1100) {
+                nec_bits |= 0x80000000UL;
+            }
+            nec_count++;
+            nec_state = NEC_BIT_MARK;
+            return;
+        }
+        break;
+    case NEC_REPEAT_MARK:
+        if (edge.mark && near(edge.microseconds, 560) && nec_valid) {
+            push_key(IR_REMOTE_NEC, nec_address, nec_command, true);
+        }
+        nec_state = NEC_IDLE;
+        return;
+    }
+    nec_state = NEC_IDLE;
+    if (edge.mark && near(edge.microseconds, 9000)) {
+        nec_state = NEC_LEADER_SPACE;
+    }
+}
+
+// RC5, automat G. Carpentera: stany to początek i środek bitu 1 lub 0,
+// zdarzenia to krótki (889 µs) lub długi (1778 µs) impuls albo przerwa;
+// przejście do tego samego stanu oznacza błąd.
+
+#define RC5_START1 0
+#define RC5_MID1 1
+#define RC5_MID0 2
+#define RC5_START0 3
+#define RC5_IDLE 4
+
+#define RC5_SHORT_SPACE 0
+#define RC5_SHORT_MARK 2
+#define RC5_LONG_SPACE 4
+#define RC5_LONG_MARK 6
+
+static const uint8_t rc5_transitions[4] = { 0x01, 0x91, 0x9B, 0xFB };
+
+static uint8_t rc5_state = RC5_IDLE;
+static uint16_t rc5_bits;
+static uint8_t rc5_count;
+static int8_t rc5_toggle = -1; // bit przełączania poprzedniej ramki
+
+static void rc5_frame(void) {
+    const uint8_t toggle = (rc5_bits >> 11) & 1;
+    const uint8_t address = (rc5_bits >> 6) & 0x1F;
+    // S2 to zanegowany 7. bit komendy (RC5 rozszerzone)
+    const uint8_t command = (rc5_bits & 0x3F) | ((rc5_bits & 0x1000) ? 0 : 0x40);
+    push_key(IR_REMOTE_RC5, address, command, toggle == rc5_toggle);
+    rc5_toggle = toggle;
+}
+
+static void rc5_edge(edge_t edge) {
+    if (edge.microseconds == GAP || (!edge.mark && edge.microseconds > 2500)) {
+        // długa przerwa: następny impuls to środek bitu startowego S1
+        rc5_state = RC5_MID1;
+        rc5_bits = 1;
+        rc5_count = 1;
+        return;
+    }
+    if (rc5_state == RC5_IDLE) {
+        return;
+    }
+    uint8_t event;
+    if (near(edge.microseconds, 889)) {
+        event = edge.mark ? RC5_SHORT_MARK : RC5_SHORT_SPACE;
+    } else if (near(edge.microseconds, 1778)) {
+        event = edge.mark ? RC5_LONG_MARK : RC5_LONG_SPACE;
+    } else {
+        rc5_state = RC5_IDLE;
+        return;
+    }
+    const uint8_t state = (rc5_transitions[rc5_state] >> event) & 3;
+    if (state == rc5_state) {
+        rc5_state = RC5_IDLE;
+        return;
+    }
+    rc5_state = state;
+    if (state == RC5_MID0 || state == RC5_MID1) {
+        rc5_bits = (rc5_bits << 1) | (state == RC5_MID1);
+        if (++rc5_count == 14) {
+            rc5_frame();
+            rc5_state = RC5_IDLE;
+        }
+    }
+}
+
+bool ir_remote_read(ir_remote_key_t* key) {
+    edge_t edge;
+    while (keys_is_empty() && edges_read(&edge)) {
+        nec_edge(edge);
+        rc5_edge(edge);
+    }
+    return keys_read(key);
+}
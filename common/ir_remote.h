@@ -0,0 +1,39 @@
+#ifndef __IR_REMOTE_H
+#define __IR_REMOTE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Dekoder pilotów na podczerwień (NEC i RC5).
+//
+// Odbiornik 38 kHz (wyjście aktywne niskie) podłączony do ICP1 (PB0).
+// Timer1 liczy z preskalerem 8 (0.5 µs), a przerwanie input capture przy
+// każdym zboczu odwraca ICES1 i wrzuca do bufora cyklicznego czas trwania
+// zakończonego stanu w µs i to, czy był to impuls (nośna). Przepełnienie
+// licznika bez zbocza oznacza długą przerwę. Obsługa zbocza to kilkadziesiąt
+// cykli, więc dekoder może działać obok PWM i UART.
+//
+// Właściwe dekodowanie odbywa się w pętli głównej w ir_remote_read():
+// zbocza z bufora trafiają jednocześnie do automatów NEC i RC5, a rozpoznane
+// klawisze do kolejki. NEC: nagłówek 9 ms + 4.5 ms, 32 bity (adres, adres
+// lub jego negacja, komenda, negacja komendy), kod powtórzenia 9 + 2.25 ms.
+// RC5: 14 bitów Manchester po 1.778 ms, bit przełączania odróżnia nowe
+// naciśnięcie od przytrzymania.
+
+typedef enum {
+    IR_REMOTE_NEC = 0,
+    IR_REMOTE_RC5 = 1,
+} ir_remote_protocol_t;
+
+typedef struct {
+    ir_remote_protocol_t protocol;
+    uint16_t address; // NEC: 8 bitów albo 16 w wersji rozszerzonej; RC5: 5 bitów
+    uint8_t command; // NEC: 8 bitów; RC5: 7 bitów
+    bool repeat; // klawisz przytrzymany
+} ir_remote_key_t;
+
+void ir_remote_initialize(void); /* Ustawia Timer1 i PB0, włącza przerwania */
+/* Dekoduje zebrane zbocza; true, gdy w key jest kolejny klawisz */
+bool ir_remote_read(ir_remote_key_t* key);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef __LM35_H
+#define __LM35_H
+
+#include <stdint.h>
+
+// Przeliczenia dla czujnika LM35 (10 mV/°C, czyli 1 mV na d°C) z przesunięciem
+// 500 mV (0°C = 500 mV) mierzonego przy referencji 1.1 V. Same obliczenia
+// bez rejestrów, więc tools/simulator kompiluje je na komputerze.
+
+#define LM35_VREF_MILIVOLTS 1100
+#define LM35_ZERO_MILIVOLTS 500
+
+static inline uint16_t adc_to_milivolts(uint32_t adc) {
+    return (adc * LM35_VREF_MILIVOLTS) / 1024;
+}
+
+static inline int16_t milivolts_to_decycelsius(uint16_t milivolts) {
+    return (int16_t)milivolts - LM35_ZERO_MILIVOLTS;
+}
+
+static inline uint16_t decycelsius_to_milivolts(int16_t decycelsius) {
+    return decycelsius + LM35_ZERO_MILIVOLTS;
+}
+
+static inline uint16_t milivolts_to_adc(uint32_t milivolts) {
+    return (1024 * milivolts) / LM35_VREF_MILIVOLTS;
+}
+
+#endif
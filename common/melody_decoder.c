@@ -0,0 +1,93 @@
+#include "melody_decoder.h"
+#include <avr/pgmspace.h>
+
+static inline uint8_t read_byte(melody_decoder_t* decoder) {
+    return pgm_read_byte(decoder->position++);
+}
+
+static uint16_t read_varint(melody_decoder_t* decoder) {
+    uint16_t value = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        byte = read_byte(decoder);
+        value |= (uint16_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && shift < 16);
+    return value;
+}
+
+void melody_decoder_initialize(melody_decoder_t* decoder, const uint8_t* data) {
+    decoder->data = data;
+    melody_decoder_rewind(decoder);
+}
+
+void melody_decoder_rewind(melody_decoder_t* decoder) {
+    decoder->position = decoder->data;
+    decoder->pitch = 60;
+    decoder->length = MELODY_WHOLE / 4;
+    decoder->depth = 0;
+}
+
+// Zwraca false, gdy trzeba przerwać (przepełniony stos powtórzeń).
+static bool repeat(melody_decoder_t* decoder) {
+    const uint8_t* const op = decoder->position - 1;
+    const uint8_t count = read_byte(decoder);
+    const uint8_t pitch = read_byte(decoder);
+    const uint16_t distance = read_varint(decoder);
+
+    melody_repeat_t* top = decoder->depth > 0 ? &decoder->repeats[decoder->depth - 1] : 0;
+    if (top == 0 || top->repeat != op) {
+        // pierwsze dojście do tego rozkazu: blok zagrał raz
+        if (decoder->depth == MELODY_REPEAT_DEPTH) {
+            decoder->position = op;
+            return false;
+        }
+        top = &decoder->repeats[decoder->depth++];
+        top->repeat = op;
+        top->remaining = count;
+    }
+    if (top->remaining != 0 && --top->remaining == 0) {
+        decoder->depth--;
+        return true;
+    }
+    decoder->pitch = pitch;
+    decoder->position = op - distance;
+    return true;
+}
+
+bool melody_decoder_next(melody_decoder_t* decoder, melody_note_t* note) {
+    while (1) {
+        const uint8_t op = read_byte(decoder);
+        if (op < MELODY_REST) {
+            decoder->pitch += (op & 0x3F) - 32;
+            if (op & MELODY_NOTE) {
+                decoder->length = read_varint(decoder);
+            }
+            note->pitch = decoder->pitch;
+            note->length = decoder->length;
+            return true;
+        }
+        switch (op) {
+        case MELODY_REST:
+            decoder->length = read_varint(decoder);
+            // fall through
+        case MELODY_REST_SAME:
+            note->pitch = MELODY_SILENCE;
+            note->length = decoder->length;
+            return true;
+        case MELODY_PITCH:
+            decoder->pitch = read_byte(decoder);
+            break;
+        case MELODY_REPEAT:
+            if (!repeat(decoder)) {
+                return false;
+            }
+            break;
+        default:
+            // MELODY_END albo nieznany rozkaz: stój w miejscu
+            decoder->position--;
+            return false;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef __MELODY_DECODER_H
+#define __MELODY_DECODER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Strumieniowy dekoder skompresowanych melodii z PROGMEM (koder:
+// tools/melody).
+//
+// Format to ciąg rozkazów bajtowych:
+//     00dddddd            nuta o d - 32 półtonów od poprzedniej, długość
+//                         jak poprzednia
+//     01dddddd <długość>  nuta o d - 32 półtonów od poprzedniej
+//     10000000 <długość>  pauza
+//     10000001            pauza o długości jak poprzednia
+//     10000010 <wysokość> ustawia wysokość odniesienia (skok > 31 półtonów)
+//     10000011 <ile> <wysokość> <odległość>
+//                         powtórz blok zaczynający się odległość bajtów
+//                         wcześniej, tak by zagrał ile razy (0 = bez końca);
+//                         przed każdym powtórzeniem wysokość odniesienia
+//                         wraca do podanej
+//     11111111            koniec
+// Długość i odległość to liczby zmiennej długości (po 7 bitów, najmłodsze
+// najpierw, ustawiony bit 7 oznacza kolejny bajt). Długość jest w 1/256
+// całej nuty, wysokość to numer półtonu jak w MIDI (C4 = 60).
+//
+// Powtórzenia można zagnieżdżać do MELODY_REPEAT_DEPTH poziomów. Dekoder
+// trzyma tylko wskaźnik, dwie wartości odniesienia i stos powtórzeń, więc
+// może pracować w przerwaniu (np. jako źródło common/sequencer).
+
+#ifndef MELODY_REPEAT_DEPTH
+#define MELODY_REPEAT_DEPTH 4
+#endif
+
+#define MELODY_NOTE_SAME 0x00
+#define MELODY_NOTE 0x40
+#define MELODY_DELTA(semitones) ((semitones) + 32)
+#define MELODY_REST 0x80
+#define MELODY_REST_SAME 0x81
+#define MELODY_PITCH 0x82
+#define MELODY_REPEAT 0x83
+#define MELODY_END 0xFF
+
+#define MELODY_WHOLE 256 // długość całej nuty
+#define MELODY_SILENCE 0xFF // wysokość zwracana dla pauzy
+
+typedef struct {
+    const uint8_t* repeat; // adres rozkazu powtórzenia
+    uint8_t remaining; // 0 = bez końca
+} melody_repeat_t;
+
+typedef struct {
+    const uint8_t* data;
+    const uint8_t* position;
+    uint8_t pitch;
+    uint16_t length;
+    uint8_t depth;
+    melody_repeat_t repeats[MELODY_REPEAT_DEPTH];
+} melody_decoder_t;
+
+typedef struct {
+    uint8_t pitch; // MELODY_SILENCE dla pauzy
+    uint16_t length; // w 1/MELODY_WHOLE całej nuty
+} melody_note_t;
+
+void melody_decoder_initialize(melody_decoder_t* decoder, const uint8_t* data); /* data w PROGMEM */
+void melody_decoder_rewind(melody_decoder_t* decoder);
+/* Wypełnia note i zwraca true albo zwraca false na końcu (lub przy błędzie) */
+bool melody_decoder_next(melody_decoder_t* decoder, melody_note_t* note);
+
+#endif
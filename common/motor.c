@@ -0,0 +1,115 @@
+#include "motor.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#define DEAD_TIME_PERIODS ((uint8_t)((MOTOR_DEAD_TIME_US * MOTOR_PWM_RATE + 999999UL) / 1000000UL))
+
+static volatile int16_t target = 0;
+static volatile int16_t speed = 0;
+static volatile uint16_t step = 0; // przyrost na okres PWM w 8.8, 0 = bez rampy
+static uint16_t fraction = 0;
+static int8_t direction = 0; // ostatni kierunek jazdy, 0 -- jeszcze nie ruszał
+static uint8_t stopped = 0; // pełne okresy na zerze, najwyżej DEAD_TIME_PERIODS
+
+static inline void set_outputs(int16_t value) {
+    if (value >= 0) {
+        OCR1B = 0;
+        OCR1A = value;
+    } else {
+        OCR1A = 0;
+        OCR1B = -value;
+    }
+}
+
+ISR(TIMER1_OVF_vect) {
+    const int16_t current = speed;
+    if (current != 0) {
+        stopped = 0;
+    } else if (stopped < DEAD_TIME_PERIODS) {
+        stopped++;
+    }
+    const int16_t goal = target;
+    if (current == goal) {
+        // na zerze przerwanie liczy jeszcze przerwę, żeby późniejsza zmiana
+        // kierunku wiedziała, ile już trwała
+        if (current != 0 || stopped == DEAD_TIME_PERIODS) {
+            TIMSK1 &= ~_BV(TOIE1);
+        }
+        return;
+    }
+    // ruszanie z zera w przeciwnym kierunku niż ostatnio tylko po przerwie,
+    // niezależnie od tego, czy zero było celem, czy krokiem rampy
+    if (current == 0) {
+        const int8_t heading = goal > 0 ? 1 : -1;
+        if (direction != 0 && heading != direction && stopped < DEAD_TIME_PERIODS) {
+            return;
+        }
+        direction = heading;
+    }
+    uint16_t limit = UINT16_MAX;
+    if (step != 0) {
+        fraction += step;
+        limit = fraction >> 8;
+        fraction &= 0xFF;
+    }
+    int16_t next;
+    if (goal > current) {
+        next = (uint16_t)(goal - current) > limit ? current + limit : goal;
+    } else {
+        next = (uint16_t)(current - goal) > limit ? current - limit : goal;
+    }
+    // zmiana kierunku tylko przez zero
+    if ((current > 0 && next < 0) || (current < 0 && next > 0)) {
+        next = 0;
+    }
+    speed = next;
+    set_outputs(next);
+}
+
+void motor_initialize(void) {
+    OCR1A = 0;
+    OCR1B = 0;
+    // ustaw tryb licznika
+    // COM1A = 10   -- non-inverting mode
+    // COM1B = 10   -- non-inverting mode
+    // WGM1  = 1010 -- phase correct PWM top=ICR1
+    // CS1   = 001  -- prescaler 1
+    // częstotliwość 16e6/(2*1000) = 8 kHz
+    ICR1 = MOTOR_MAX;
+    TCCR1A = _BV(COM1A1) | _BV(COM1B1) | _BV(WGM11);
+    TCCR1B = _BV(WGM13) | _BV(CS10);
+    // ustaw pin OC1A i OC1B (PB1, PB2) jako wyjście
+    DDRB |= _BV(PB1) | _BV(PB2);
+    sei();
+}
+
+void motor_set_speed(int16_t value) {
+    if (value > MOTOR_MAX) {
+        value = MOTOR_MAX;
+    } else if (value < -MOTOR_MAX) {
+        value = -MOTOR_MAX;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        target = value;
+        TIMSK1 |= _BV(TOIE1);
+    }
+}
+
+void motor_set_acceleration(uint16_t per_second) {
+    uint16_t value = ((uint32_t)per_second * 256 + MOTOR_PWM_RATE / 2) / MOTOR_PWM_RATE;
+    if (per_second != 0 && value == 0) {
+        value = 1;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        step = value;
+    }
+}
+
+int16_t motor_speed(void) {
+    int16_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        value = speed;
+    }
+    return value;
+}
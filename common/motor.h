@@ -0,0 +1,37 @@
+#ifndef __MOTOR_H
+#define __MOTOR_H
+
+#include <stdint.h>
+
+// Sterownik silnika DC na mostku H.
+//
+// Timer1 w trybie phase correct PWM (TOP = ICR1) bez preskalera daje
+// MOTOR_PWM_RATE Hz na obu wyjściach: OC1A (PB1) napędza do przodu, OC1B
+// (PB2) do tyłu, nieaktywne wyjście ma wypełnienie 0. Phase correct zmienia
+// OCR1x tylko w TOP, więc wypełnienie nie ma szpilek przy aktualizacji.
+//
+// motor_set_speed() tylko zapisuje wartość zadaną i można ją wołać choćby
+// co milisekundę. Przerwanie przepełnienia (w BOTTOM, raz na okres PWM)
+// zbliża aktualną prędkość do zadanej z ograniczonym przyspieszeniem,
+// a przy zmianie kierunku zatrzymuje się na zerze i trzyma oba wyjścia
+// nisko przez MOTOR_DEAD_TIME_US. Przerwa obowiązuje przy każdym ruszeniu
+// w kierunku przeciwnym do ostatniej jazdy, także gdy silnik zatrzymano
+// wcześniej osobnym wywołaniem; czas postoju na zerze się do niej wlicza.
+// Gdy prędkość osiągnie zadaną (a na zerze także po upływie przerwy),
+// przerwanie się wyłącza.
+
+#define MOTOR_PWM_RATE 8000UL
+#define MOTOR_MAX ((int16_t)(F_CPU / 2 / MOTOR_PWM_RATE)) // pełne wypełnienie, 1000 przy 16 MHz
+
+#ifndef MOTOR_DEAD_TIME_US
+#define MOTOR_DEAD_TIME_US 500
+#endif
+
+void motor_initialize(void); /* Ustawia Timer1 i piny PB1, PB2, silnik stoi */
+/* Prędkość zadana -MOTOR_MAX..MOTOR_MAX (przycinana), znak to kierunek */
+void motor_set_speed(int16_t speed);
+/* Przyspieszenie w jednostkach prędkości na sekundę (0 = skok od razu) */
+void motor_set_acceleration(uint16_t per_second);
+int16_t motor_speed(void); /* Aktualna prędkość (po rampie) */
+
+#endif
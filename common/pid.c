@@ -0,0 +1,79 @@
+#include "pid.h"
+
+#define FRACTION PID_GAIN_FRACTION_BITS
+
+static inline int16_t saturate(int32_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return value;
+}
+
+static inline pid_accumulator_t multiply(pid_gain_t gain, int16_t value) {
+    return (pid_accumulator_t)gain * value;
+}
+
+// b * r bez mnożenia w typowych przypadkach b = 1 i b = 0
+static inline int32_t weighted(pid_gain_t weight, int16_t setpoint) {
+    if (weight == PID_ONE) {
+        return setpoint;
+    }
+    if (weight == 0) {
+        return 0;
+    }
+    return multiply(weight, setpoint) >> FRACTION;
+}
+
+void pid_initialize(pid_controller_t* pid, const pid_parameters_t* parameters) {
+    pid->parameters = *parameters;
+    pid_reset(pid);
+}
+
+void pid_reset(pid_controller_t* pid) {
+    pid->integral = 0;
+    pid->derivative = 0;
+    pid->last_derivative_error = 0;
+    pid->primed = 0;
+}
+
+int16_t pid_update(pid_controller_t* pid, int16_t setpoint, int16_t measurement) {
+    const pid_parameters_t* parameters = &pid->parameters;
+
+    const int16_t proportional_error = saturate(weighted(parameters->setpoint_weight_p, setpoint) - measurement);
+    const pid_accumulator_t proportional = multiply(parameters->kp, proportional_error);
+
+    const int16_t error = saturate((int32_t)setpoint - measurement);
+    pid->integral += multiply(parameters->ki, error);
+
+    const int16_t derivative_error = saturate(weighted(parameters->setpoint_weight_d, setpoint) - measurement);
+    if (!pid->primed) {
+        // bez skoku pochodnej w pierwszym kroku
+        pid->last_derivative_error = derivative_error;
+        pid->primed = 1;
+    }
+    const pid_accumulator_t raw_derivative =
+        multiply(parameters->kd, saturate((int32_t)derivative_error - pid->last_derivative_error));
+    pid->last_derivative_error = derivative_error;
+    pid->derivative += (raw_derivative - pid->derivative) >> parameters->derivative_filter_shift;
+
+    const pid_accumulator_t total = (proportional + pid->integral + pid->derivative) >> FRACTION;
+    int16_t output = saturate(total);
+    if (total > parameters->output_max) {
+        output = parameters->output_max;
+    } else if (total < parameters->output_min) {
+        output = parameters->output_min;
+    }
+
+    pid->integral += multiply(parameters->kt, saturate(output - total));
+    const pid_accumulator_t integral_max = (pid_accumulator_t)parameters->output_max << FRACTION;
+    const pid_accumulator_t integral_min = (pid_accumulator_t)parameters->output_min << FRACTION;
+    if (pid->integral > integral_max) {
+        pid->integral = integral_max;
+    } else if (pid->integral < integral_min) {
+        pid->integral = integral_min;
+    }
+    return output;
+}
@@ -0,0 +1,68 @@
+#ifndef __PID_H
+#define __PID_H
+
+#include <stdint.h>
+
+// Regulator PID w arytmetyce stałoprzecinkowej, dowolnie wiele instancji.
+//
+// Wzmocnienia mają PID_GAIN_FRACTION_BITS bitów części ułamkowej: 16 (Q16.16,
+// domyślnie, iloczyny 64-bitowe) albo 8 (Q8.8, iloczyny 16x16 -> 32, kilka
+// razy szybciej). Wybór obowiązuje cały program, więc ustawia się go w DEFS.
+// Ki i Kd są na próbkę, czyli Ki = Kp * T / Ti i Kd = Kp * Td / T.
+//
+// Wyjście (przed obcięciem do [output_min, output_max]):
+//     P = Kp * (b * r - y)
+//     I += Ki * (r - y) + Kt * (u - v)      -- back-calculation
+//     D = filtr(Kd * ((c * r - y) - poprzednie))
+// gdzie b i c to wagi wartości zadanej (zwykle b = 1, c = 0, czyli
+// pochodna tylko z pomiaru, bez skoku przy zmianie r), u to wyjście po
+// obcięciu, a v przed. Kt (zwykle Ki / Kp) ściąga całkę, gdy wyjście jest
+// nasycone. Filtr pochodnej to średnia wykładnicza z wagą
+// 1/2^derivative_filter_shift (0 = bez filtra). Dodatkowo całka nigdy nie
+// wychodzi poza zakres wyjścia.
+
+#ifndef PID_GAIN_FRACTION_BITS
+#define PID_GAIN_FRACTION_BITS 16
+#endif
+
+#if PID_GAIN_FRACTION_BITS == 16
+typedef int32_t pid_gain_t;
+typedef int64_t pid_accumulator_t;
+#elif PID_GAIN_FRACTION_BITS == 8
+typedef int16_t pid_gain_t;
+typedef int32_t pid_accumulator_t;
+#else
+#error "PID_GAIN_FRACTION_BITS must be 8 or 16"
+#endif
+
+// stała zmiennoprzecinkowa -> wzmocnienie, liczone w czasie kompilacji
+#define PID_GAIN(value) ((pid_gain_t)((value) * (1L << PID_GAIN_FRACTION_BITS) + ((value) >= 0 ? 0.5 : -0.5)))
+#define PID_ONE PID_GAIN(1)
+
+typedef struct {
+    pid_gain_t kp;
+    pid_gain_t ki;
+    pid_gain_t kd;
+    pid_gain_t kt; // wzmocnienie back-calculation, 0 = wyłączone
+    pid_gain_t setpoint_weight_p; // b
+    pid_gain_t setpoint_weight_d; // c
+    uint8_t derivative_filter_shift;
+    int16_t output_min;
+    int16_t output_max;
+} pid_parameters_t;
+
+typedef struct {
+    pid_parameters_t parameters;
+    pid_accumulator_t integral;
+    pid_accumulator_t derivative;
+    int16_t last_derivative_error;
+    uint8_t primed;
+} pid_controller_t;
+
+/* Kopiuje parametry i zeruje stan; parametry można potem zmieniać w pid->parameters */
+void pid_initialize(pid_controller_t* pid, const pid_parameters_t* parameters);
+void pid_reset(pid_controller_t* pid); /* Zeruje całkę i filtr pochodnej */
+/* Jeden krok regulatora; wynik w [output_min, output_max] */
+int16_t pid_update(pid_controller_t* pid, int16_t setpoint, int16_t measurement);
+
+#endif
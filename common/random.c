@@ -0,0 +1,98 @@
+#include "random.h"
+#include <avr/io.h>
+#include <util/atomic.h>
+
+// dowolny niezerowy stan: generator działa też bez random_initialize()
+static uint32_t state = 2463534242UL;
+static uint32_t cache;
+static uint8_t cached = 0;
+
+static uint32_t harvest_adc(void) {
+    const uint8_t admux = ADMUX;
+    const uint8_t adcsra = ADCSRA;
+    uint32_t pool = 0;
+    ADMUX = RANDOM_ADC_MUX;
+    // preskaler 16 (1 MHz): poza zakresem dokładności, więc więcej szumu
+    ADCSRA = _BV(ADEN) | _BV(ADPS2);
+    for (uint8_t index = 0; index < RANDOM_ADC_SAMPLES; index++) {
+        ADCSRA |= _BV(ADSC); // wykonaj konwersję
+        loop_until_bit_is_clear(ADCSRA, ADSC); // czekaj na wynik
+        random_pool_add(&pool, ADC);
+    }
+    ADCSRA = adcsra | _BV(ADIF); // przywróć ustawienia i wyczyść flagę
+    ADMUX = admux;
+    return pool;
+}
+
+// Wołać przy wyłączonych przerwaniach: WDT_vect nie jest obsłużone, więc
+// czekamy na flagę WDIF zamiast na przerwanie.
+static uint32_t harvest_watchdog(void) {
+    uint32_t pool = 0;
+    MCUSR &= ~_BV(WDRF);
+    // WDIE = 1, WDP = 0000 -- tryb przerwania, 16 ms
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE);
+    WDTCSR |= _BV(WDIF);
+    for (uint8_t index = 0; index < RANDOM_WDT_SAMPLES; index++) {
+        uint16_t count = 0;
+        while (!(WDTCSR & _BV(WDIF))) {
+            count++;
+        }
+        WDTCSR |= _BV(WDIF); // wyczyść flagę (pisząc 1!)
+        random_pool_add(&pool, count);
+    }
+    // wyłącz watchdog
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = 0;
+    return pool;
+}
+
+void random_initialize(void) {
+    uint32_t adc;
+    uint32_t watchdog;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        adc = harvest_adc();
+        watchdog = harvest_watchdog();
+    }
+    state = random_seed(adc, watchdog);
+    cached = 0;
+}
+
+void random_add_entropy(uint16_t sample) {
+    state = random_mix32(state ^ sample);
+    if (state == 0) {
+        state = 1;
+    }
+}
+
+uint8_t random_byte(void) {
+    if (cached == 0) {
+        cache = random_xorshift32(&state);
+        cached = 4;
+    }
+    cached--;
+    const uint8_t result = cache;
+    cache >>= 8;
+    return result;
+}
+
+uint16_t random_u16(void) {
+    return random_xorshift32(&state) >> 16;
+}
+
+uint32_t random_u32(void) {
+    return random_xorshift32(&state);
+}
+
+// Lemire: górne 16 bitów iloczynu losowej liczby i bound, z odrzuceniem
+// tych kilku wartości, które dawałyby nierówne szanse
+uint16_t random_range(uint16_t bound) {
+    uint32_t product = (uint32_t)random_u16() * bound;
+    if ((uint16_t)product < bound) {
+        const uint16_t threshold = (uint16_t)-bound % bound;
+        while ((uint16_t)product < threshold) {
+            product = (uint32_t)random_u16() * bound;
+        }
+    }
+    return product >> 16;
+}
@@ -0,0 +1,75 @@
+#ifndef __RANDOM_H
+#define __RANDOM_H
+
+#include <stdint.h>
+
+// Generator liczb losowych ze sprzętowym ziarnem.
+//
+// random_initialize() zbiera entropię z dwóch źródeł:
+//  - najmłodszych bitów RANDOM_ADC_SAMPLES szybkich pomiarów ADC wejścia
+//    RANDOM_ADC_MUX (najlepiej niepodłączonego),
+//  - jittera między zegarem procesora (kwarc) a oscylatorem RC watchdoga:
+//    liczba obiegów pętli w RANDOM_WDT_SAMPLES okresach WDT (16 ms) zmienia
+//    się o kilka ostatnich bitów.
+// Próbki trafiają do puli (obrót i xor), a wynik wybiela funkcja mieszająca
+// (finalizer MurmurHash3), której każdy bit wejścia zmienia średnio połowę
+// bitów wyjścia. Zebranie entropii trwa ok. RANDOM_WDT_SAMPLES * 16 ms,
+// przy wyłączonych przerwaniach; WDT kończy wyłączony.
+//
+// Właściwy generator to xorshift32 (okres 2^32 - 1): trzy przesunięcia
+// i xor na słowo, z którego random_byte() wydaje kolejno cztery bajty.
+// Koszt w cyklach mierzy list_04/task_1, a statystykę strumienia
+// tools/random.
+//
+// Funkcje nie są przeznaczone do wołania jednocześnie z przerwania i pętli
+// głównej.
+
+#ifndef RANDOM_ADC_MUX
+#define RANDOM_ADC_MUX _BV(REFS0) // ADC0, referencja AVcc
+#endif
+
+#ifndef RANDOM_ADC_SAMPLES
+#define RANDOM_ADC_SAMPLES 64
+#endif
+
+#ifndef RANDOM_WDT_SAMPLES
+#define RANDOM_WDT_SAMPLES 8
+#endif
+
+// https://en.wikipedia.org/wiki/Xorshift
+static inline uint32_t random_xorshift32(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// finalizer MurmurHash3 (fmix32)
+static inline uint32_t random_mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6B;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35;
+    x ^= x >> 16;
+    return x;
+}
+
+static inline void random_pool_add(uint32_t* pool, uint16_t sample) {
+    *pool = ((*pool << 7) | (*pool >> 25)) ^ sample;
+}
+
+// ziarno z obu pul; stała rozdziela je, gdy wyszły takie same
+static inline uint32_t random_seed(uint32_t adc_pool, uint32_t watchdog_pool) {
+    const uint32_t seed = random_mix32(adc_pool) ^ random_mix32(watchdog_pool + 0x9E3779B9);
+    return seed != 0 ? seed : 1;
+}
+
+void random_initialize(void); /* Zbiera entropię i ustawia ziarno */
+void random_add_entropy(uint16_t sample); /* Domieszuje dodatkową próbkę do stanu */
+uint8_t random_byte(void);
+uint16_t random_u16(void);
+uint32_t random_u32(void);
+uint16_t random_range(uint16_t bound); /* Równomiernie z 0..bound-1; bound > 0 */
+
+#endif
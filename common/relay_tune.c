@@ -0,0 +1,140 @@
+#include "relay_tune.h"
+
+// 4 / pi w Q16.16
+#define FOUR_OVER_PI 83443
+
+typedef struct {
+    uint16_t kp; // Kp / Ku w promilach
+    uint16_t ti; // Ti / Tu w promilach
+    uint16_t td; // Td / Tu w promilach
+} rule_t;
+
+static const rule_t rules[] = {
+    [RELAY_TUNE_CLASSIC] = { 600, 500, 125 },
+    [RELAY_TUNE_NO_OVERSHOOT] = { 200, 500, 333 },
+};
+
+void relay_tune_start(relay_tune_t* tune, int16_t setpoint, int16_t hysteresis, int16_t output_high,
+                      int16_t output_low, uint32_t timeout) {
+    tune->setpoint = setpoint;
+    tune->hysteresis = hysteresis;
+    tune->output_high = output_high;
+    tune->output_low = output_low;
+    tune->timeout = timeout;
+    tune->status = RELAY_TUNE_RUNNING;
+    tune->high = true;
+    tune->samples = 0;
+    tune->last_switch = 0;
+    tune->maximum = INT16_MIN;
+    tune->minimum = INT16_MAX;
+    tune->cycles = 0;
+    tune->period_sum = 0;
+    tune->amplitude_sum = 0;
+    tune->period = 0;
+    tune->amplitude = 0;
+}
+
+// przełączenie na high zamyka okres: od poprzedniego takiego przełączenia
+// pomiar przeszedł przez maksimum i minimum
+static void finish_cycle(relay_tune_t* tune) {
+    if (tune->cycles >= RELAY_TUNE_SKIP_CYCLES) {
+        tune->period_sum += tune->samples - tune->last_switch;
+        tune->amplitude_sum += tune->maximum - tune->minimum;
+    }
+    tune->cycles++;
+    if (tune->cycles == RELAY_TUNE_SKIP_CYCLES + RELAY_TUNE_CYCLES) {
+        tune->period = tune->period_sum / RELAY_TUNE_CYCLES;
+        tune->amplitude = tune->amplitude_sum / (2 * RELAY_TUNE_CYCLES);
+        tune->status = tune->amplitude > tune->hysteresis ? RELAY_TUNE_DONE : RELAY_TUNE_FAILED;
+    }
+    tune->maximum = INT16_MIN;
+    tune->minimum = INT16_MAX;
+}
+
+int16_t relay_tune_update(relay_tune_t* tune, int16_t measurement) {
+    if (tune->status != RELAY_TUNE_RUNNING) {
+        return tune->output_low;
+    }
+    if (++tune->samples > tune->timeout) {
+        tune->status = RELAY_TUNE_FAILED;
+        return tune->output_low;
+    }
+    if (measurement > tune->maximum) {
+        tune->maximum = measurement;
+    }
+    if (measurement < tune->minimum) {
+        tune->minimum = measurement;
+    }
+    if (tune->high && measurement > tune->setpoint + tune->hysteresis) {
+        tune->high = false;
+    } else if (!tune->high && measurement < tune->setpoint - tune->hysteresis) {
+        tune->high = true;
+        // pierwszy okres zaczyna się od pierwszego powrotu pod setpoint
+        if (tune->last_switch != 0) {
+            finish_cycle(tune);
+        } else {
+            tune->maximum = INT16_MIN;
+            tune->minimum = INT16_MAX;
+        }
+        tune->last_switch = tune->samples;
+    }
+    if (tune->status != RELAY_TUNE_RUNNING) {
+        return tune->output_low;
+    }
+    return tune->high ? tune->output_high : tune->output_low;
+}
+
+static uint32_t square_root(uint32_t value) {
+    uint32_t result = 0;
+    for (uint32_t bit = 1UL << 30; bit != 0; bit >>= 2) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+    }
+    return result;
+}
+
+bool relay_tune_gains(const relay_tune_t* tune, relay_tune_rule_t rule, pid_parameters_t* parameters) {
+    if (tune->status != RELAY_TUNE_DONE) {
+        return false;
+    }
+    const int32_t amplitude = tune->amplitude;
+    const int32_t hysteresis = tune->hysteresis;
+    const uint32_t effective = square_root(amplitude * amplitude - hysteresis * hysteresis);
+    if (effective == 0) {
+        return false;
+    }
+    const int32_t relay = ((int32_t)tune->output_high - tune->output_low) / 2;
+    // Ku w Q16.16
+    const int64_t ultimate = (int64_t)FOUR_OVER_PI * relay / effective;
+    const rule_t* coefficients = &rules[rule];
+    const int64_t kp = ultimate * coefficients->kp / 1000;
+    // Ki = Kp / Ti, Kd = Kp * Td, Ti i Td w próbkach
+    const int64_t ki = kp * 1000 / ((int64_t)tune->period * coefficients->ti);
+    const int64_t kd = kp * tune->period * coefficients->td / 1000;
+    const int64_t kt = (int64_t)65536 * 1000 / ((int64_t)tune->period * coefficients->ti); // Ki / Kp
+
+    const uint8_t shift = 16 - PID_GAIN_FRACTION_BITS;
+    const int64_t limit = ((int64_t)1 << (8 * sizeof(pid_gain_t) - 1)) - 1;
+    const int64_t gains[4] = { kp >> shift, ki >> shift, kd >> shift, kt >> shift };
+    for (uint8_t index = 0; index < 4; index++) {
+        if (gains[index] > limit) {
+            return false;
+        }
+    }
+    parameters->kp = gains[0];
+    parameters->ki = gains[1];
+    parameters->kd = gains[2];
+    parameters->kt = gains[3];
+    // stała filtra pochodnej około Td / 8, jak N = 8 w klasycznym członie D
+    const uint32_t filter = (uint32_t)tune->period * coefficients->td / 1000 / 8;
+    uint8_t filter_shift = 0;
+    while (filter_shift < 7 && (2UL << filter_shift) <= filter) {
+        filter_shift++;
+    }
+    parameters->derivative_filter_shift = filter_shift;
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef __RELAY_TUNE_H
+#define __RELAY_TUNE_H
+
+#include "pid.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Automatyczny dobór nastaw PID metodą przekaźnikową (Åström-Hägglund).
+//
+// Zamiast regulatora pętlę zamyka przekaźnik z histerezą: wyjście high,
+// dopóki pomiar nie przekroczy setpoint + hysteresis, potem low, dopóki nie
+// spadnie poniżej setpoint - hysteresis. Obiekt wpada w stabilne drgania
+// o okresie Tu (okres krytyczny), a z amplitudy drgań a i amplitudy
+// przekaźnika d = (high - low) / 2 wychodzi wzmocnienie krytyczne
+//     Ku = 4 d / (pi sqrt(a^2 - hysteresis^2))
+// Pierwsze RELAY_TUNE_SKIP_CYCLES okresów (dojście do setpointu) jest
+// pomijane, a wynik to średnia z RELAY_TUNE_CYCLES kolejnych.
+//
+// relay_tune_update() woła się co próbkę, tak jak pid_update() (np.
+// w przerwaniu ADC), bez dzielenia. Nastawy liczy relay_tune_gains() raz,
+// po zakończeniu pomiaru, z reguły Zieglera-Nicholsa:
+//     klasyczna:        Kp = 0.6 Ku,  Ti = Tu / 2,  Td = Tu / 8
+//     bez przeregulowania: Kp = 0.2 Ku,  Ti = Tu / 2,  Td = Tu / 3
+// Ki i Kd wychodzą na próbkę, jak oczekuje common/pid, a filtr pochodnej
+// dostaje stałą czasową około Td / 8.
+//
+// Kod nie zależy od sprzętu, więc tools/autotune testuje go na modelu
+// cieplnym na komputerze.
+
+#define RELAY_TUNE_SKIP_CYCLES 1
+#define RELAY_TUNE_CYCLES 3
+
+typedef enum {
+    RELAY_TUNE_RUNNING = 0,
+    RELAY_TUNE_DONE = 1,
+    RELAY_TUNE_FAILED = 2, // przekroczony czas albo drgania mniejsze niż histereza
+} relay_tune_status_t;
+
+typedef enum {
+    RELAY_TUNE_CLASSIC = 0,
+    RELAY_TUNE_NO_OVERSHOOT = 1,
+} relay_tune_rule_t;
+
+typedef struct {
+    // ustawienia
+    int16_t setpoint;
+    int16_t hysteresis;
+    int16_t output_high;
+    int16_t output_low;
+    uint32_t timeout; // maksymalna liczba próbek
+    // stan
+    relay_tune_status_t status;
+    bool high;
+    uint32_t samples;
+    uint32_t last_switch; // próbka ostatniego przełączenia na high
+    int16_t maximum;
+    int16_t minimum;
+    uint8_t cycles;
+    uint32_t period_sum;
+    uint32_t amplitude_sum; // podwójne amplitudy (max - min)
+    // wynik
+    uint16_t period; // Tu w próbkach
+    uint16_t amplitude; // a w jednostkach pomiaru
+} relay_tune_t;
+
+/* Zaczyna pomiar; wyjście przekaźnika to output_high albo output_low */
+void relay_tune_start(relay_tune_t* tune, int16_t setpoint, int16_t hysteresis, int16_t output_high,
+                      int16_t output_low, uint32_t timeout);
+/* Jeden krok przekaźnika; zwraca wyjście (po zakończeniu output_low) */
+int16_t relay_tune_update(relay_tune_t* tune, int16_t measurement);
+/* Wpisuje kp, ki, kd, kt i derivative_filter_shift (reszta bez zmian); false, gdy pomiar się nie udał */
+bool relay_tune_gains(const relay_tune_t* tune, relay_tune_rule_t rule, pid_parameters_t* parameters);
+
+#endif
@@ -0,0 +1,185 @@
+#include "rgb_fade.h"
+#include "ring_buffer.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#define RED_OCR OCR0B
+#define GREEN_OCR OCR1B
+#define BLUE_OCR OCR1A
+
+// ```julia
+// @pipe range(0, 1, length=256) |>
+// map(x -> round(Int, x^2.2 * 255), _) |>
+// foreach(x -> print("$x, "), _)
+// ```
+static const uint8_t gamma_table[256] PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6,
+    6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 11, 11, 11, 12,
+    12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
+    20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
+    30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
+    42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+    73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
+    91, 93, 94, 95, 97, 98, 99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+typedef struct {
+    rgb_fade_hsv_t target;
+    uint16_t ticks;
+    rgb_fade_easing_t easing;
+} transition_t;
+
+RING_BUFFER_CREATE(transitions, transition_t, 8);
+
+// trwające przejście; zapisywane tylko w przerwaniu
+static volatile bool active = false;
+static transition_t current;
+static rgb_fade_hsv_t color;
+static rgb_fade_hsv_t start;
+static int16_t hue_delta;
+static uint16_t elapsed;
+static uint16_t progress; // Q0.16
+static uint16_t progress_step;
+
+// a * (b + 1) / 256: 0 dla b = 0, a dla b = 255
+static inline uint8_t scale(uint8_t a, uint8_t b) {
+    return ((uint16_t)a * (b + 1)) >> 8;
+}
+
+static inline uint16_t square(uint16_t t) {
+    return ((uint32_t)t * t) >> 16;
+}
+
+static uint16_t ease(uint16_t t, rgb_fade_easing_t easing) {
+    switch (easing) {
+    case RGB_FADE_EASE_IN:
+        return square(t);
+    case RGB_FADE_EASE_OUT:
+        return ~square(~t);
+    case RGB_FADE_EASE_IN_OUT:
+        // 3 - 2t w Q2.14
+        return ((uint32_t)square(t) * (3 * 16384U - (t >> 1))) >> 14;
+    default:
+        return t;
+    }
+}
+
+// start + (target - start) * t dla liczby 8.8
+static inline uint16_t interpolate(uint16_t from, uint16_t to, uint16_t t) {
+    if (to >= from) {
+        return from + (((uint32_t)(to - from) * t) >> 16);
+    }
+    return from - (((uint32_t)(from - to) * t) >> 16);
+}
+
+static void output(void) {
+    const uint8_t saturation = color.saturation >> 8;
+    const uint8_t value = color.value >> 8;
+    // odcień * 6: sektor w starszym słowie, położenie w nim w bajcie niżej
+    const uint32_t position = (uint32_t)color.hue * 6;
+    const uint8_t sector = position >> 16;
+    const uint8_t fraction = position >> 8;
+
+    const uint8_t p = scale(value, 255 - saturation);
+    const uint8_t q = scale(value, 255 - scale(saturation, fraction));
+    const uint8_t t = scale(value, 255 - scale(saturation, 255 - fraction));
+    uint8_t red, green, blue;
+    switch (sector) {
+    case 0:
+        red = value, green = t, blue = p;
+        break;
+    case 1:
+        red = q, green = value, blue = p;
+        break;
+    case 2:
+        red = p, green = value, blue = t;
+        break;
+    case 3:
+        red = p, green = q, blue = value;
+        break;
+    case 4:
+        red = t, green = p, blue = value;
+        break;
+    default:
+        red = value, green = p, blue = q;
+        break;
+    }
+    red = pgm_read_byte(&gamma_table[red]);
+    green = pgm_read_byte(&gamma_table[green]);
+    blue = pgm_read_byte(&gamma_table[blue]);
+#if RGB_FADE_INVERTED
+    red = 255 - red;
+    green = 255 - green;
+    blue = 255 - blue;
+#endif
+    RED_OCR = red;
+    GREEN_OCR = green;
+    BLUE_OCR = blue;
+}
+
+ISR(TIMER1_OVF_vect) {
+    if (!active) {
+        if (!transitions_read(&current)) {
+            return;
+        }
+        start = color;
+        // krótszy łuk: różnica odcieni modulo pełny obrót
+        hue_delta = current.target.hue - color.hue;
+        elapsed = 0;
+        progress = 0;
+        progress_step = current.ticks > 0 ? UINT16_MAX / current.ticks : 0;
+        active = true;
+    }
+
+    if (++elapsed >= current.ticks) {
+        color = current.target;
+        active = false;
+    } else {
+        progress += progress_step;
+        const uint16_t t = ease(progress, current.easing);
+        color.hue = start.hue + (int16_t)(((int32_t)hue_delta * t) >> 16);
+        color.saturation = interpolate(start.saturation, current.target.saturation, t);
+        color.value = interpolate(start.value, current.target.value, t);
+    }
+    output();
+}
+
+void rgb_fade_initialize(void) {
+    color = RGB_FADE_HSV(0, 0, 0);
+    output();
+    // czerwony: Timer0
+    // COM0B = 10  -- non-inverting mode
+    // WGM0  = 011 -- fast PWM, top=0xFF
+    // CS0   = 011 -- prescaler 64
+    TCCR0A = _BV(COM0B1) | _BV(WGM01) | _BV(WGM00);
+    TCCR0B = _BV(CS01) | _BV(CS00);
+    DDRD |= _BV(PD5);
+    // zielony i niebieski: Timer1
+    // COM1A = 10   -- non-inverting mode
+    // COM1B = 10   -- non-inverting mode
+    // WGM1  = 0101 -- fast PWM, 8-bit, top=0xFF
+    // CS1   = 011  -- prescaler 64
+    TCCR1A = _BV(COM1A1) | _BV(COM1B1) | _BV(WGM10);
+    TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);
+    DDRB |= _BV(PB1) | _BV(PB2);
+    TIMSK1 = _BV(TOIE1);
+    sei();
+}
+
+bool rgb_fade_enqueue(rgb_fade_hsv_t target, uint16_t milliseconds, rgb_fade_easing_t easing) {
+    const transition_t transition = { target, RGB_FADE_TICKS(milliseconds), easing };
+    return transitions_write(transition);
+}
+
+uint8_t rgb_fade_pending(void) {
+    return transitions_count() + (active ? 1 : 0);
+}
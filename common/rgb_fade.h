@@ -0,0 +1,50 @@
+#ifndef __RGB_FADE_H
+#define __RGB_FADE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Płynne przejścia koloru diody RGB w przerwaniu.
+//
+// Moduł ustawia sprzętowy PWM 8-bit z preskalerem 64 (~977 Hz): czerwony na
+// OC0B (PD5), zielony na OC1B (PB2), niebieski na OC1A (PB1). Przerwanie
+// przepełnienia Timer1 (RGB_FADE_RATE razy na sekundę) zdejmuje przejścia
+// z kolejki i interpoluje kolor w HSV, gdzie każda składowa to liczba 8.8
+// (odcień: pełny obrót = 65536, po krótszym łuku). Postęp przejścia
+// przechodzi przez krzywą (easing), a wynik HSV -> RGB przez tablicę gamma
+// 2.2. Gdy kolejka jest pusta, przerwanie tylko sprawdza kolejkę.
+//
+// Pętla główna tylko dopisuje przejścia (rgb_fade_enqueue) i może spać.
+//
+// Dioda ze wspólną anodą świeci przy stanie niskim, stąd domyślnie
+// RGB_FADE_INVERTED = 1.
+
+#ifndef RGB_FADE_INVERTED
+#define RGB_FADE_INVERTED 1
+#endif
+
+#define RGB_FADE_RATE (F_CPU / 64 / 256)
+#define RGB_FADE_TICKS(milliseconds) ((uint16_t)(((uint32_t)(milliseconds)*RGB_FADE_RATE + 500) / 1000))
+
+typedef struct {
+    uint16_t hue; // 0 czerwony, 21845 zielony, 43691 niebieski
+    uint16_t saturation; // 8.8, 0xFF00 = pełne nasycenie
+    uint16_t value; // 8.8, 0xFF00 = pełna jasność
+} rgb_fade_hsv_t;
+
+#define RGB_FADE_HSV(degrees, saturation, value) \
+    ((rgb_fade_hsv_t){ (uint16_t)((degrees)*65536UL / 360), (uint16_t)(saturation) << 8, (uint16_t)(value) << 8 })
+
+typedef enum {
+    RGB_FADE_LINEAR = 0,
+    RGB_FADE_EASE_IN = 1, // t^2
+    RGB_FADE_EASE_OUT = 2, // 1 - (1 - t)^2
+    RGB_FADE_EASE_IN_OUT = 3, // t^2 (3 - 2t)
+} rgb_fade_easing_t;
+
+void rgb_fade_initialize(void); /* Ustawia Timer0 i Timer1, gasi diodę, włącza przerwania */
+/* Dopisuje przejście do koloru target w danym czasie (0 = od razu); false, gdy kolejka pełna */
+bool rgb_fade_enqueue(rgb_fade_hsv_t target, uint16_t milliseconds, rgb_fade_easing_t easing);
+uint8_t rgb_fade_pending(void); /* Przejścia w kolejce, łącznie z trwającym */
+
+#endif
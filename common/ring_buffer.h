@@ -0,0 +1,163 @@
+#ifndef __RING_BUFFER_H
+#define __RING_BUFFER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Bufor cykliczny jeden producent / jeden konsument (np. przerwanie i pętla
+// główna) dla dowolnego typu elementów.
+//
+// Rozmiar musi być potęgą dwójki nie większą niż 128. Wskaźniki head i tail
+// są jednobajtowymi licznikami, które rosną bez ograniczeń (przepełniają się
+// modulo 256), a indeks w tablicy to licznik & (size - 1). Dzięki temu:
+//  - liczba elementów to po prostu (uint8_t)(head - tail), nie trzeba
+//    zostawiać pustego miejsca, żeby odróżnić pełny bufor od pustego,
+//  - head zapisuje tylko producent, tail zapisuje tylko konsument, a zapis
+//    jednego bajtu na AVR jest atomowy, więc żadna ze stron nie potrzebuje
+//    cli()/sei(),
+//  - producent najpierw zapisuje dane, potem (za barierą kompilatora)
+//    publikuje nowe head; konsument najpierw czyta dane, potem publikuje
+//    nowe tail. Druga strona widzi więc albo stary, albo nowy licznik i w obu
+//    przypadkach spójną zawartość.
+//
+// Strona, która jest przerwaniem, może wołać funkcje bez ograniczeń. Strona
+// w pętli głównej nie może być wywłaszczona przez drugiego producenta lub
+// konsumenta tego samego bufora.
+//
+// Użycie:
+//     RING_BUFFER_CREATE(samples, uint16_t, 32);
+//     ISR(ADC_vect) { samples_write(ADC); }
+//     ...
+//     uint16_t block[8];
+//     uint8_t count = samples_read_n(block, 8);
+
+#define RING_BUFFER_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+#define RING_BUFFER_CREATE(name, type, size)                                                          \
+    _Static_assert((size) > 0 && (size) <= 128 && ((size) & ((size)-1)) == 0,                         \
+                   #name ": size must be a power of two <= 128");                                     \
+    static type name##_data[(size)];                                                                  \
+    static volatile uint8_t name##_head = 0;                                                          \
+    static volatile uint8_t name##_tail = 0;                                                          \
+                                                                                                      \
+    /* liczba elementów gotowych do odczytu */                                                        \
+    static inline uint8_t name##_count(void) {                                                        \
+        return (uint8_t)(name##_head - name##_tail);                                                  \
+    }                                                                                                 \
+                                                                                                      \
+    /* liczba wolnych miejsc */                                                                       \
+    static inline uint8_t name##_free(void) {                                                         \
+        return (size)-name##_count();                                                                 \
+    }                                                                                                 \
+                                                                                                      \
+    static inline bool name##_is_empty(void) {                                                        \
+        return name##_head == name##_tail;                                                            \
+    }                                                                                                 \
+                                                                                                      \
+    static inline bool name##_is_full(void) {                                                         \
+        return name##_count() == (size);                                                              \
+    }                                                                                                 \
+                                                                                                      \
+    /* producent: dopisz jeden element, false gdy brak miejsca */                                     \
+    static inline bool name##_write(type value) {                                                     \
+        const uint8_t head = name##_head;                                                             \
+        if ((uint8_t)(head - name##_tail) == (size)) {                                                \
+            return false;                                                                             \
+        }                                                                                             \
+        name##_data[head & ((size)-1)] = value;                                                       \
+        RING_BUFFER_BARRIER();                                                                        \
+        name##_head = head + 1;                                                                       \
+        return true;                                                                                  \
+    }                                                                                                 \
+                                                                                                      \
+    /* konsument: zdejmij jeden element, false gdy bufor pusty */                                     \
+    static inline bool name##_read(type* value) {                                                     \
+        const uint8_t tail = name##_tail;                                                             \
+        if (name##_head == tail) {                                                                    \
+            return false;                                                                             \
+        }                                                                                             \
+        RING_BUFFER_BARRIER();                                                                        \
+        *value = name##_data[tail & ((size)-1)];                                                      \
+        RING_BUFFER_BARRIER();                                                                        \
+        name##_tail = tail + 1;                                                                       \
+        return true;                                                                                  \
+    }                                                                                                 \
+                                                                                                      \
+    /* producent: ciągły obszar do zapisu bez kopiowania; zwraca jego długość */                     \
+    static inline uint8_t name##_reserve(type** data) {                                               \
+        const uint8_t head = name##_head;                                                             \
+        const uint8_t space = (size) - (uint8_t)(head - name##_tail);                                 \
+        const uint8_t index = head & ((size)-1);                                                      \
+        const uint8_t until_end = (size)-index;                                                       \
+        *data = &name##_data[index];                                                                  \
+        return space < until_end ? space : until_end;                                                 \
+    }                                                                                                 \
+                                                                                                      \
+    /* producent: opublikuj count elementów zapisanych przez reserve */                               \
+    static inline void name##_commit(uint8_t count) {                                                 \
+        RING_BUFFER_BARRIER();                                                                        \
+        name##_head = name##_head + count;                                                            \
+    }                                                                                                 \
+                                                                                                      \
+    /* konsument: ciągły obszar do odczytu bez kopiowania; zwraca jego długość */                    \
+    static inline uint8_t name##_peek(const type** data) {                                            \
+        const uint8_t tail = name##_tail;                                                             \
+        const uint8_t count = (uint8_t)(name##_head - tail);                                          \
+        const uint8_t index = tail & ((size)-1);                                                      \
+        const uint8_t until_end = (size)-index;                                                       \
+        RING_BUFFER_BARRIER();                                                                        \
+        *data = &name##_data[index];                                                                  \
+        return count < until_end ? count : until_end;                                                 \
+    }                                                                                                 \
+                                                                                                      \
+    /* konsument: zwolnij count elementów odczytanych przez peek */                                   \
+    static inline void name##_consume(uint8_t count) {                                                \
+        RING_BUFFER_BARRIER();                                                                        \
+        name##_tail = name##_tail + count;                                                            \
+    }                                                                                                 \
+                                                                                                      \
+    /* producent: dopisz do count elementów, zwraca ile faktycznie zapisano */                        \
+    static inline uint8_t name##_write_n(const type* values, uint8_t count) {                         \
+        uint8_t written = 0;                                                                          \
+        while (written < count) {                                                                     \
+            type* data;                                                                               \
+            uint8_t chunk = name##_reserve(&data);                                                    \
+            if (chunk == 0) {                                                                         \
+                break;                                                                                \
+            }                                                                                         \
+            if (chunk > count - written) {                                                            \
+                chunk = count - written;                                                              \
+            }                                                                                         \
+            memcpy(data, values + written, chunk * sizeof(type));                                     \
+            name##_commit(chunk);                                                                     \
+            written += chunk;                                                                         \
+        }                                                                                             \
+        return written;                                                                               \
+    }                                                                                                 \
+                                                                                                      \
+    /* konsument: zdejmij do count elementów, zwraca ile faktycznie odczytano */                      \
+    static inline uint8_t name##_read_n(type* values, uint8_t count) {                                \
+        uint8_t read = 0;                                                                             \
+        while (read < count) {                                                                        \
+            const type* data;                                                                         \
+            uint8_t chunk = name##_peek(&data);                                                       \
+            if (chunk == 0) {                                                                         \
+                break;                                                                                \
+            }                                                                                         \
+            if (chunk > count - read) {                                                               \
+                chunk = count - read;                                                                 \
+            }                                                                                         \
+            memcpy(values + read, data, chunk * sizeof(type));                                        \
+            name##_consume(chunk);                                                                    \
+            read += chunk;                                                                            \
+        }                                                                                             \
+        return read;                                                                                  \
+    }                                                                                                 \
+                                                                                                      \
+    /* konsument: porzuć całą zawartość */                                                            \
+    static inline void name##_clear(void) {                                                           \
+        name##_tail = name##_head;                                                                    \
+    }
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef __RUNNING_STATS_H
+#define __RUNNING_STATS_H
+
+#include <stdint.h>
+
+// Statystyki strumienia próbek w stałej pamięci: liczba, średnia, wariancja,
+// minimum i maksimum, bez przechowywania samych próbek.
+//
+// Klasyczny algorytm Welforda dzieli przy każdej próbce przez n, co na AVR
+// kosztuje setki cykli, a we float przestaje działać przy milionach próbek
+// (przyrost średniej delta / n ginie poniżej precyzji mantysy). Dla próbek
+// całkowitych (kody ADC) ten sam efekt, czyli brak odejmowania dwóch
+// ogromnych sum, daje akumulacja przesunięta o pierwszą próbkę:
+//     sum = suma (x - first), squares = suma (x - first)^2
+//     mean = first + sum / n, M2 = squares - sum^2 / n
+// Sumy są dokładne (całkowite), bo odchylenia od first są rzędu szumu.
+//
+// running_stats_add to kilka dodawań i jedno mnożenie 16x16, więc nadaje
+// się do ADC_vect. Odczyt wyników (mean/variance) jest we float i powinien
+// działać na kopii struktury zrobionej przy zablokowanych przerwaniach.
+//
+// Ograniczenia: sum mieści się w int32_t, dopóki n * |x - first| < 2^31
+// (np. 2 mln próbek odchylonych o 1023 kody), squares w uint64_t zawsze.
+
+typedef struct {
+    uint32_t count;
+    uint16_t first;
+    int32_t sum;
+    uint64_t squares;
+    uint16_t min;
+    uint16_t max;
+} running_stats_t;
+
+static inline void running_stats_reset(running_stats_t* stats) {
+    stats->count = 0;
+    stats->first = 0;
+    stats->sum = 0;
+    stats->squares = 0;
+    stats->min = UINT16_MAX;
+    stats->max = 0;
+}
+
+static inline void running_stats_add(running_stats_t* stats, uint16_t sample) {
+    if (stats->count == 0) {
+        stats->first = sample;
+    }
+    const int16_t deviation = sample - stats->first;
+    stats->count++;
+    stats->sum += deviation;
+    stats->squares += (uint32_t)((int32_t)deviation * deviation);
+    if (sample < stats->min) {
+        stats->min = sample;
+    }
+    if (sample > stats->max) {
+        stats->max = sample;
+    }
+}
+
+/* suma kwadratów odchyleń od średniej (M2 Welforda) */
+static inline uint64_t running_stats_m2(const running_stats_t* stats) {
+    if (stats->count == 0) {
+        return 0;
+    }
+    const uint64_t sum_squared = (uint64_t)((int64_t)stats->sum * stats->sum);
+    return stats->squares - sum_squared / stats->count;
+}
+
+static inline float running_stats_mean(const running_stats_t* stats) {
+    if (stats->count == 0) {
+        return 0;
+    }
+    return stats->first + (float)stats->sum / stats->count;
+}
+
+/* wariancja populacji (M2 / n), w kwadratach jednostek próbki */
+static inline float running_stats_variance(const running_stats_t* stats) {
+    if (stats->count == 0) {
+        return 0;
+    }
+    return (float)running_stats_m2(stats) / stats->count;
+}
+
+#endif
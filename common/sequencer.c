@@ -0,0 +1,86 @@
+#include "sequencer.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stddef.h>
+
+static volatile sequencer_source_t source = NULL;
+static volatile bool playing = false;
+static uint16_t remaining = 0;
+
+#define BUZZ_DDR DDRB
+#define BUZZ_PORT PORTB
+#define BUZZ PB1 // OC1A
+
+static void silence(void) {
+    // odłącz OC1A od timera i zostaw pin w stanie niskim
+    TCCR1A = 0;
+    BUZZ_PORT &= ~_BV(BUZZ);
+}
+
+// Ustawia następną nutę; wołane przy zablokowanych przerwaniach.
+static void advance(void) {
+    sequencer_note_t note;
+    while (source(&note)) {
+        if (note.milliseconds == 0) {
+            continue;
+        }
+        remaining = note.milliseconds;
+        if (note.top == 0) {
+            silence();
+        } else {
+            // nowy TOP mógłby być mniejszy niż licznik, wtedy licznik
+            // przeszedłby przez 0xFFFF; zaczynamy okres od zera
+            OCR1A = note.top;
+            TCNT1 = 0;
+            TCCR1A = _BV(COM1A0); // toggle OC1A on compare match
+        }
+        return;
+    }
+    sequencer_stop();
+}
+
+ISR(TIMER0_COMPA_vect) {
+    if (--remaining == 0) {
+        advance();
+    }
+}
+
+void sequencer_initialize(void) {
+    BUZZ_DDR |= _BV(BUZZ);
+    silence();
+    // ustaw tryb licznika (ton)
+    // WGM1  = 0100 -- CTC, TOP = OCR1A
+    // CS1   = 010  -- prescaler 8
+    TCCR1B = _BV(WGM12) | _BV(CS11);
+    // ustaw tryb licznika (czas trwania)
+    // WGM0  = 010 -- CTC
+    // CS0   = 011 -- prescaler 64
+    // OCR0A = 249 -- 16e6 / (64 * 250) = 1 kHz
+    TCCR0A = _BV(WGM01);
+    OCR0A = F_CPU / 64 / 1000 - 1;
+    TCCR0B = _BV(CS01) | _BV(CS00);
+}
+
+void sequencer_play(sequencer_source_t new_source) {
+    cli();
+    source = new_source;
+    playing = true;
+    TCNT0 = 0;
+    TIFR0 = _BV(OCF0A);
+    TIMSK0 = _BV(OCIE0A);
+    advance();
+    sei();
+}
+
+void sequencer_stop(void) {
+    const uint8_t sreg = SREG;
+    cli();
+    TIMSK0 = 0;
+    silence();
+    playing = false;
+    SREG = sreg;
+}
+
+bool sequencer_is_playing(void) {
+    return playing;
+}
@@ -0,0 +1,32 @@
+#ifndef __SEQUENCER_H
+#define __SEQUENCER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Odtwarzanie melodii w całości na sprzęcie i w przerwaniach.
+//
+// Timer1 w trybie CTC przełącza pin OC1A (PB1) przy każdym dopasowaniu,
+// więc ton ma częstotliwość F_CPU / (2 * 8 * (top + 1)) i nie zależy od
+// tego, co robi procesor. Timer0 co 1 ms odlicza czas trwania nuty i po
+// jej końcu pobiera następną przez funkcję source (wołaną w przerwaniu,
+// więc powinna być krótka, np. odczyt z PROGMEM). Pętla główna jest wolna.
+//
+// Zakres tonów przy preskalerze 8: od ~15.3 Hz (top = 65535) w górę.
+
+#define SEQUENCER_TOP(millihertz) ((uint16_t)(((F_CPU / 8 * 500ULL) + (millihertz) / 2) / (millihertz) - 1))
+
+typedef struct {
+    uint16_t top; // SEQUENCER_TOP(częstotliwość); 0 oznacza pauzę
+    uint16_t milliseconds;
+} sequencer_note_t;
+
+/* Wypełnia note i zwraca true albo zwraca false na końcu melodii */
+typedef bool (*sequencer_source_t)(sequencer_note_t* note);
+
+void sequencer_initialize(void); /* Ustawia PB1 jako wyjście i Timer0/Timer1 */
+void sequencer_play(sequencer_source_t source); /* Zaczyna odtwarzanie od pierwszej nuty, włącza przerwania */
+void sequencer_stop(void);
+bool sequencer_is_playing(void);
+
+#endif
@@ -0,0 +1,116 @@
+#include "servo.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdbool.h>
+#include <util/atomic.h>
+
+#define TICKS(microseconds) ((microseconds)*2U) // preskaler 8, 0.5 µs
+#define FRAMES_PER_SECOND (1000000UL / SERVO_FRAME_US)
+
+typedef struct {
+    volatile uint8_t* port;
+    uint8_t bit;
+} pin_t;
+
+static const pin_t pins[SERVO_COUNT] = { SERVO_PINS };
+
+static uint16_t working[SERVO_COUNT]; // bufor roboczy (pętla główna), w tickach
+static uint16_t published[SERVO_COUNT]; // ostatnio opublikowany
+static volatile bool update_pending = false;
+
+// stan przerwania
+static uint16_t targets[SERVO_COUNT];
+static uint16_t positions[SERVO_COUNT];
+static uint16_t steps[SERVO_COUNT]; // maksymalna zmiana na ramkę, 0 = bez ograniczenia
+static uint8_t channel = 0;
+static bool pulse = false;
+
+static inline uint16_t approach(uint16_t position, uint16_t target, uint16_t step) {
+    if (step == 0 || position == SERVO_OFF || target == SERVO_OFF) {
+        return target;
+    }
+    if (target > position) {
+        return target - position > step ? position + step : target;
+    }
+    return position - target > step ? position - step : target;
+}
+
+ISR(TIMER1_COMPA_vect) {
+    const pin_t pin = pins[channel];
+    if (pulse) {
+        // koniec impulsu, czekaj do końca szczeliny
+        *pin.port &= ~_BV(pin.bit);
+        OCR1A += TICKS(SERVO_SLOT_US) - positions[channel];
+        pulse = false;
+        if (++channel == SERVO_COUNT) {
+            channel = 0;
+        }
+        return;
+    }
+    if (channel == 0 && update_pending) {
+        for (uint8_t index = 0; index < SERVO_COUNT; index++) {
+            targets[index] = published[index];
+        }
+        update_pending = false;
+    }
+    const uint16_t position = approach(positions[channel], targets[channel], steps[channel]);
+    positions[channel] = position;
+    if (position == SERVO_OFF) {
+        // pusta szczelina
+        OCR1A += TICKS(SERVO_SLOT_US);
+        if (++channel == SERVO_COUNT) {
+            channel = 0;
+        }
+        return;
+    }
+    *pin.port |= _BV(pin.bit);
+    OCR1A += position;
+    pulse = true;
+}
+
+void servo_initialize(void) {
+    for (uint8_t index = 0; index < SERVO_COUNT; index++) {
+        *pins[index].port &= ~_BV(pins[index].bit);
+        // DDRx leży adres niżej niż PORTx
+        *(pins[index].port - 1) |= _BV(pins[index].bit);
+    }
+    // ustaw tryb licznika
+    // WGM1  = 0000 -- normal, OCR1A przesuwany w przerwaniu
+    // CS1   = 010  -- prescaler 8, 0.5 µs
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11);
+    OCR1A = TCNT1 + TICKS(SERVO_SLOT_US);
+    TIFR1 = _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+    sei();
+}
+
+void servo_write(uint8_t channel, uint16_t microseconds) {
+    if (microseconds != SERVO_OFF) {
+        if (microseconds < SERVO_MIN_US) {
+            microseconds = SERVO_MIN_US;
+        } else if (microseconds > SERVO_MAX_US) {
+            microseconds = SERVO_MAX_US;
+        }
+    }
+    working[channel] = TICKS(microseconds);
+}
+
+void servo_update(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for (uint8_t index = 0; index < SERVO_COUNT; index++) {
+            published[index] = working[index];
+        }
+        update_pending = true;
+    }
+}
+
+void servo_set_speed(uint8_t channel, uint16_t microseconds_per_second) {
+    uint16_t step = TICKS((uint32_t)microseconds_per_second) / FRAMES_PER_SECOND;
+    if (microseconds_per_second != 0 && step == 0) {
+        step = 1;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        steps[channel] = step;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef __SERVO_H
+#define __SERVO_H
+
+#include <stdint.h>
+
+// Sterowanie do SERVO_COUNT serwami z jednego Timer1.
+//
+// Timer1 liczy swobodnie z preskalerem 8 (0.5 µs), a przerwanie OC1A
+// przesuwa OCR1A o kolejne odcinki: ramka 20 ms jest podzielona na
+// SERVO_COUNT szczelin po SERVO_SLOT_US, w każdej szczelinie jeden kanał
+// dostaje impuls (wejście w przerwanie ustawia pin, następne go gasi).
+// Czasy liczone są od poprzedniego porównania, a nie od wejścia do
+// przerwania, więc opóźnienie obsługi (np. przez UART) nie kumuluje się.
+//
+// Pozycje są podwójnie buforowane: servo_write() zmienia tylko bufor
+// roboczy, a servo_update() publikuje wszystkie kanały naraz - przerwanie
+// przepisuje je na początku następnej ramki, więc serwa ruszają razem.
+// Opcjonalne ograniczenie prędkości (servo_set_speed) przesuwa impuls
+// najwyżej o zadaną liczbę µs na ramkę.
+//
+// Piny ustawia SERVO_PINS: pary (port, bit), domyślnie PB1, PB2, PD2..PD7
+// (PD0 i PD1 zostają dla UART).
+
+#ifndef SERVO_PINS
+#define SERVO_PINS                                                                              \
+    { &PORTB, PB1 }, { &PORTB, PB2 }, { &PORTD, PD2 }, { &PORTD, PD3 }, { &PORTD, PD4 },         \
+        { &PORTD, PD5 }, { &PORTD, PD6 }, { &PORTD, PD7 }
+#endif
+
+#define SERVO_COUNT 8
+#define SERVO_FRAME_US 20000
+#define SERVO_SLOT_US (SERVO_FRAME_US / SERVO_COUNT)
+// zapas na obsługę przerwania przed początkiem kolejnej szczeliny
+#define SERVO_MIN_US 500
+#define SERVO_MAX_US (SERVO_SLOT_US - 100)
+#define SERVO_OFF 0 // brak impulsów na kanale
+
+void servo_initialize(void); /* Ustawia piny i Timer1, włącza przerwania; wszystkie kanały wyłączone */
+/* Ustawia impuls kanału w µs (przycinany do SERVO_MIN_US..SERVO_MAX_US, SERVO_OFF wyłącza) w buforze roboczym */
+void servo_write(uint8_t channel, uint16_t microseconds);
+void servo_update(void); /* Publikuje bufor roboczy od następnej ramki */
+/* Ogranicza szybkość zmiany impulsu do microseconds_per_second (0 = skok od razu) */
+void servo_set_speed(uint8_t channel, uint16_t microseconds_per_second);
+
+#endif
@@ -0,0 +1,221 @@
+#include "soft_pwm.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdbool.h>
+#include <util/atomic.h>
+
+#define PORTS 3
+
+_Static_assert(SOFT_PWM_PERIOD <= 65535, "SOFT_PWM_PERIOD must fit in Timer1");
+
+// ```julia
+// @pipe range(0, 1, length=256) |>
+// map(x -> round(Int, x^2.2 * 65535), _) |>
+// foreach(x -> print("$x, "), _)
+// ```
+static const uint16_t gamma_table[256] PROGMEM = {
+    0, 0, 2, 4, 7, 11, 17, 24, 32, 42, 53, 65,
+    79, 94, 111, 129, 148, 169, 192, 216, 242, 270, 299, 330,
+    362, 396, 432, 469, 508, 549, 591, 635, 681, 729, 779, 830,
+    883, 938, 995, 1053, 1113, 1175, 1239, 1305, 1373, 1443, 1514, 1587,
+    1663, 1740, 1819, 1900, 1983, 2068, 2155, 2243, 2334, 2427, 2521, 2618,
+    2717, 2817, 2920, 3024, 3131, 3240, 3350, 3463, 3578, 3694, 3813, 3934,
+    4057, 4182, 4309, 4438, 4570, 4703, 4838, 4976, 5115, 5257, 5401, 5547,
+    5695, 5845, 5998, 6152, 6309, 6468, 6629, 6792, 6957, 7124, 7294, 7466,
+    7640, 7816, 7994, 8175, 8358, 8543, 8730, 8919, 9111, 9305, 9501, 9699,
+    9900, 10102, 10307, 10515, 10724, 10936, 11150, 11366, 11585, 11806, 12029, 12254,
+    12482, 12712, 12944, 13179, 13416, 13655, 13896, 14140, 14386, 14635, 14885, 15138,
+    15394, 15652, 15912, 16174, 16439, 16706, 16975, 17247, 17521, 17798, 18077, 18358,
+    18642, 18928, 19216, 19507, 19800, 20095, 20393, 20694, 20996, 21301, 21609, 21919,
+    22231, 22546, 22863, 23182, 23504, 23829, 24156, 24485, 24817, 25151, 25487, 25826,
+    26168, 26512, 26858, 27207, 27558, 27912, 28268, 28627, 28988, 29351, 29717, 30086,
+    30457, 30830, 31206, 31585, 31966, 32349, 32735, 33124, 33514, 33908, 34304, 34702,
+    35103, 35507, 35913, 36321, 36732, 37146, 37562, 37981, 38402, 38825, 39252, 39680,
+    40112, 40546, 40982, 41421, 41862, 42306, 42753, 43202, 43654, 44108, 44565, 45025,
+    45487, 45951, 46418, 46888, 47360, 47835, 48313, 48793, 49275, 49761, 50249, 50739,
+    51232, 51728, 52226, 52727, 53230, 53736, 54245, 54756, 55270, 55787, 56306, 56828,
+    57352, 57879, 58409, 58941, 59476, 60014, 60554, 61097, 61642, 62190, 62741, 63295,
+    63851, 64410, 64971, 65535,
+};
+
+typedef struct {
+    uint16_t time;
+    uint8_t clear[PORTS];
+} event_t;
+
+typedef struct {
+    uint8_t mask[PORTS]; // wszystkie piny PWM
+    uint8_t set[PORTS]; // piny zapalane na początku okresu
+    uint8_t count;
+    event_t events[SOFT_PWM_MAX_CHANNELS];
+} schedule_t;
+
+typedef struct {
+    uint8_t port;
+    uint8_t mask;
+    uint16_t duty;
+} channel_t;
+
+static volatile uint8_t* const ports[PORTS] = { &PORTB, &PORTC, &PORTD };
+static volatile uint8_t* const directions[PORTS] = { &DDRB, &DDRC, &DDRD };
+
+static channel_t channels[SOFT_PWM_MAX_CHANNELS];
+static uint8_t channels_count = 0;
+
+static schedule_t schedules[2];
+static schedule_t* volatile active = &schedules[0];
+static volatile bool swap_pending = false;
+// indeks następnego zdarzenia; count oznacza początek okresu
+static uint8_t next_event = 0;
+static volatile uint16_t worst_case_cycles = 0;
+
+ISR(TIMER1_COMPA_vect) {
+    const uint16_t scheduled = OCR1A;
+    schedule_t* schedule = active;
+    uint16_t time = scheduled;
+    while (1) {
+        if (next_event >= schedule->count) {
+            // początek okresu: tu (i tylko tu) można podmienić listę
+            if (swap_pending) {
+                schedule = schedule == &schedules[0] ? &schedules[1] : &schedules[0];
+                active = schedule;
+                swap_pending = false;
+            }
+            for (uint8_t port = 0; port < PORTS; port++) {
+                if (schedule->mask[port] != 0) {
+                    *ports[port] = (*ports[port] & ~schedule->mask[port]) | schedule->set[port];
+                }
+            }
+            next_event = 0;
+        } else {
+            const event_t* event = &schedule->events[next_event];
+            for (uint8_t port = 0; port < PORTS; port++) {
+                if (event->clear[port] != 0) {
+                    *ports[port] &= ~event->clear[port];
+                }
+            }
+            next_event++;
+        }
+
+        if (next_event >= schedule->count) {
+            OCR1A = 0;
+            // jeśli licznik już przeszedł przez TOP, porównanie z 0 przepadło
+            if (TCNT1 >= time) {
+                break;
+            }
+            TIFR1 = _BV(OCF1A); // obsługujemy go od razu, bez drugiego przerwania
+            time = 0;
+            continue;
+        }
+        time = schedule->events[next_event].time;
+        const uint16_t counter = TCNT1;
+        if (time > counter && time - counter > SOFT_PWM_MIN_GAP) {
+            OCR1A = time;
+            break;
+        }
+        // za blisko na kolejne przerwanie: poczekaj tutaj
+        while (TCNT1 < time) { }
+    }
+
+    uint16_t now = TCNT1;
+    if (now < scheduled) {
+        now += SOFT_PWM_PERIOD;
+    }
+    const uint16_t cycles = now - scheduled;
+    if (cycles > worst_case_cycles) {
+        worst_case_cycles = cycles;
+    }
+}
+
+void soft_pwm_initialize(void) {
+    // ustaw tryb licznika
+    // WGM1  = 1100 -- CTC, TOP = ICR1
+    // CS1   = 001  -- prescaler 1
+    ICR1 = SOFT_PWM_PERIOD - 1;
+    OCR1A = 0;
+    TCNT1 = 0;
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS10);
+    TIMSK1 = _BV(OCIE1A);
+    sei();
+}
+
+uint8_t soft_pwm_add_channel(soft_pwm_port_t port, uint8_t bit) {
+    if (channels_count == SOFT_PWM_MAX_CHANNELS || port >= PORTS) {
+        return 0xFF;
+    }
+    channel_t* channel = &channels[channels_count];
+    channel->port = port;
+    channel->mask = _BV(bit);
+    channel->duty = 0;
+    *ports[port] &= ~channel->mask;
+    *directions[port] |= channel->mask;
+    return channels_count++;
+}
+
+void soft_pwm_set(uint8_t channel, uint8_t brightness) {
+    const uint16_t gamma = pgm_read_word(&gamma_table[brightness]);
+    soft_pwm_set_raw(channel, ((uint32_t)gamma * SOFT_PWM_PERIOD) >> 16);
+}
+
+void soft_pwm_set_raw(uint8_t channel, uint16_t duty) {
+    if (channel < channels_count) {
+        channels[channel].duty = duty;
+    }
+}
+
+void soft_pwm_commit(void) {
+    // poprzednia lista musi najpierw wejść do użytku
+    while (swap_pending) { }
+    schedule_t* schedule = active == &schedules[0] ? &schedules[1] : &schedules[0];
+
+    // kanały posortowane po wypełnieniu (sortowanie przez wstawianie)
+    uint8_t order[SOFT_PWM_MAX_CHANNELS];
+    for (uint8_t index = 0; index < channels_count; index++) {
+        uint8_t position = index;
+        while (position > 0 && channels[order[position - 1]].duty > channels[index].duty) {
+            order[position] = order[position - 1];
+            position--;
+        }
+        order[position] = index;
+    }
+
+    for (uint8_t port = 0; port < PORTS; port++) {
+        schedule->mask[port] = 0;
+        schedule->set[port] = 0;
+    }
+    schedule->count = 0;
+    for (uint8_t index = 0; index < channels_count; index++) {
+        const channel_t* channel = &channels[order[index]];
+        schedule->mask[channel->port] |= channel->mask;
+        if (channel->duty == 0) {
+            continue;
+        }
+        schedule->set[channel->port] |= channel->mask;
+        if (channel->duty > SOFT_PWM_PERIOD - SOFT_PWM_MIN_GAP) {
+            continue; // stale zapalony
+        }
+        // kanały o tym samym czasie gaśnie jedno zdarzenie
+        event_t* event;
+        if (schedule->count > 0 && schedule->events[schedule->count - 1].time == channel->duty) {
+            event = &schedule->events[schedule->count - 1];
+        } else {
+            event = &schedule->events[schedule->count++];
+            event->time = channel->duty;
+            for (uint8_t port = 0; port < PORTS; port++) {
+                event->clear[port] = 0;
+            }
+        }
+        event->clear[channel->port] |= channel->mask;
+    }
+    swap_pending = true;
+}
+
+uint16_t soft_pwm_worst_case_cycles(void) {
+    uint16_t cycles;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        cycles = worst_case_cycles;
+    }
+    return cycles;
+}
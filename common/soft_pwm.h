@@ -0,0 +1,51 @@
+#ifndef __SOFT_PWM_H
+#define __SOFT_PWM_H
+
+#include <stdint.h>
+
+// Programowy PWM na dowolnych pinach portów B, C i D (do 16 kanałów) z
+// jednego przerwania TIMER1_COMPA_vect.
+//
+// Timer1 liczy z preskalerem 1 w trybie CTC z TOP = ICR1, więc okres to
+// SOFT_PWM_PERIOD cykli procesora (domyślnie 40000, czyli 400 Hz). Na
+// początku okresu przerwanie zapala wszystkie kanały o niezerowym
+// wypełnieniu, a potem przychodzi tylko raz na każde różne wypełnienie
+// i gasi naraz wszystkie kanały, które mają ten sam czas. Lista zdarzeń
+// jest posortowana w soft_pwm_commit(), a nie w przerwaniu.
+//
+// Zmiana wypełnień jest bez zakłóceń: soft_pwm_set() zmienia tylko kopię,
+// soft_pwm_commit() buduje nową listę w drugim buforze, a przerwanie
+// podmienia bufory na początku okresu.
+//
+// Zdarzenia bliżej niż SOFT_PWM_MIN_GAP cykli są obsługiwane w tym samym
+// przerwaniu (czeka ono aktywnie na właściwy moment), a wypełnienie
+// powyżej SOFT_PWM_PERIOD - SOFT_PWM_MIN_GAP oznacza kanał stale zapalony.
+//
+// soft_pwm_worst_case_cycles() zwraca najdłuższy czas od dopasowania
+// porównania do wyjścia z przerwania (z opóźnieniem wejścia i prologiem).
+
+#ifndef SOFT_PWM_PERIOD
+#define SOFT_PWM_PERIOD 40000
+#endif
+
+#ifndef SOFT_PWM_MIN_GAP
+#define SOFT_PWM_MIN_GAP 64
+#endif
+
+#define SOFT_PWM_MAX_CHANNELS 16
+
+typedef enum {
+    SOFT_PWM_PORT_B = 0,
+    SOFT_PWM_PORT_C = 1,
+    SOFT_PWM_PORT_D = 2,
+} soft_pwm_port_t;
+
+void soft_pwm_initialize(void); /* Uruchamia Timer1 i włącza przerwania */
+/* Ustawia pin jako wyjście; zwraca numer kanału albo 0xFF gdy brak miejsca */
+uint8_t soft_pwm_add_channel(soft_pwm_port_t port, uint8_t bit);
+void soft_pwm_set(uint8_t channel, uint8_t brightness); /* Jasność 0..255 przez tablicę gamma */
+void soft_pwm_set_raw(uint8_t channel, uint16_t duty);  /* Wypełnienie w cyklach, 0..SOFT_PWM_PERIOD */
+void soft_pwm_commit(void); /* Publikuje zmiany od następnego okresu; czeka, jeśli poprzednie jeszcze nie weszły */
+uint16_t soft_pwm_worst_case_cycles(void);
+
+#endif
@@ -0,0 +1,128 @@
+#include "synth.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+_Static_assert(SYNTH_VOICES >= 1 && SYNTH_VOICES <= 4, "SYNTH_VOICES must be in 1..4");
+_Static_assert(F_CPU / SYNTH_SAMPLE_RATE <= 65536, "SYNTH_SAMPLE_RATE too low for Timer1");
+
+#define SAMPLES_PER_MILLISECOND (SYNTH_SAMPLE_RATE / 1000)
+
+// ```julia
+// @pipe range(0, 255) |>
+// map(x -> round(Int, 127 * sin(2 * pi * x / 256)), _) |>
+// foreach(x -> print("$x, "), _)
+// ```
+static const int8_t wavetable[256] PROGMEM = {
+    0, 3, 6, 9, 12, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46,
+    49, 51, 54, 57, 60, 63, 65, 68, 71, 73, 76, 78, 81, 83, 85, 88,
+    90, 92, 94, 96, 98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+    117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+    127, 127, 127, 127, 126, 126, 126, 125, 125, 124, 123, 122, 122, 121, 120, 118,
+    117, 116, 115, 113, 112, 111, 109, 107, 106, 104, 102, 100, 98, 96, 94, 92,
+    90, 88, 85, 83, 81, 78, 76, 73, 71, 68, 65, 63, 60, 57, 54, 51,
+    49, 46, 43, 40, 37, 34, 31, 28, 25, 22, 19, 16, 12, 9, 6, 3,
+    0, -3, -6, -9, -12, -16, -19, -22, -25, -28, -31, -34, -37, -40, -43, -46,
+    -49, -51, -54, -57, -60, -63, -65, -68, -71, -73, -76, -78, -81, -83, -85, -88,
+    -90, -92, -94, -96, -98, -100, -102, -104, -106, -107, -109, -111, -112, -113, -115, -116,
+    -117, -118, -120, -121, -122, -122, -123, -124, -125, -125, -126, -126, -126, -127, -127, -127,
+    -127, -127, -127, -127, -126, -126, -126, -125, -125, -124, -123, -122, -122, -121, -120, -118,
+    -117, -116, -115, -113, -112, -111, -109, -107, -106, -104, -102, -100, -98, -96, -94, -92,
+    -90, -88, -85, -83, -81, -78, -76, -73, -71, -68, -65, -63, -60, -57, -54, -51,
+    -49, -46, -43, -40, -37, -34, -31, -28, -25, -22, -19, -16, -12, -9, -6, -3,
+};
+
+typedef struct {
+    uint16_t phase;
+    uint16_t increment;
+} voice_t;
+
+static voice_t voices[SYNTH_VOICES];
+static uint8_t samples_to_millisecond = SAMPLES_PER_MILLISECOND;
+static volatile uint16_t milliseconds = 0;
+
+// Wewnętrzna pętla syntezy. Stała liczba głosów pozwala kompilatorowi
+// rozwinąć pętlę; suma do 4 głosów po ±127 mieści się w int16_t, a >> 2
+// sprowadza ją do zakresu PWM niezależnie od liczby głosów.
+static inline __attribute__((always_inline)) uint8_t mix(uint8_t count) {
+    int16_t sum = 0;
+    for (uint8_t index = 0; index < count; index++) {
+        const uint16_t phase = voices[index].phase + voices[index].increment;
+        voices[index].phase = phase;
+        sum += (int8_t)pgm_read_byte(&wavetable[phase >> 8]);
+    }
+    return 128 + (sum >> 2);
+}
+
+ISR(TIMER1_COMPA_vect) {
+    OCR2A = mix(SYNTH_VOICES);
+    if (--samples_to_millisecond == 0) {
+        samples_to_millisecond = SAMPLES_PER_MILLISECOND;
+        milliseconds++;
+    }
+}
+
+uint8_t synth_mix(uint8_t count) {
+    switch (count) {
+    case 1:
+        return mix(1);
+    case 2:
+        return mix(SYNTH_VOICES >= 2 ? 2 : SYNTH_VOICES);
+    case 3:
+        return mix(SYNTH_VOICES >= 3 ? 3 : SYNTH_VOICES);
+    default:
+        return mix(SYNTH_VOICES);
+    }
+}
+
+void synth_initialize(void) {
+    for (uint8_t index = 0; index < SYNTH_VOICES; index++) {
+        voices[index].phase = 0;
+        voices[index].increment = 0;
+    }
+    // wyjście: Timer2
+    // COM2A = 10  -- non-inverting mode
+    // WGM2  = 011 -- fast PWM 8-bit
+    // CS2   = 001 -- prescaler 1, 16e6 / 256 = 62.5 kHz
+    OCR2A = 128;
+    TCCR2A = _BV(COM2A1) | _BV(WGM21) | _BV(WGM20);
+    TCCR2B = _BV(CS20);
+    DDRB |= _BV(PB3);
+    // próbkowanie: Timer1
+    // WGM1  = 0100 -- CTC, TOP = OCR1A
+    // CS1   = 001  -- prescaler 1
+    OCR1A = F_CPU / SYNTH_SAMPLE_RATE - 1;
+    TCNT1 = 0;
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS10);
+    TIMSK1 = _BV(OCIE1A);
+    sei();
+}
+
+void synth_stop(void) {
+    TIMSK1 = 0;
+    TCCR1B = 0;
+    OCR2A = 128;
+}
+
+void synth_set_voice(uint8_t voice, uint16_t increment) {
+    if (voice >= SYNTH_VOICES) {
+        return;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        voices[voice].increment = increment;
+        if (increment == 0) {
+            // sin(0) = 0, więc wyciszony głos nie przesuwa poziomu
+            voices[voice].phase = 0;
+        }
+    }
+}
+
+uint16_t synth_milliseconds(void) {
+    uint16_t result;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        result = milliseconds;
+    }
+    return result;
+}
@@ -0,0 +1,39 @@
+#ifndef __SYNTH_H
+#define __SYNTH_H
+
+#include <stdint.h>
+
+// Wielogłosowa synteza tablicowa z wyjściem na PWM jako przetwornik C/A.
+//
+// Timer2 generuje 8-bitowy fast PWM 62.5 kHz na OC2A (PB3); po filtrze RC
+// (np. 1 kΩ + 100 nF) to wyjście analogowe. Timer1 w trybie CTC wywołuje
+// przerwanie z częstotliwością SYNTH_SAMPLE_RATE, które dla każdego głosu
+// dodaje przyrost do 16-bitowej fazy, czyta próbkę z tablicy sinusa
+// w PROGMEM (górny bajt fazy to indeks), sumuje głosy i wpisuje wynik do
+// OCR2A. Częstotliwość głosu to increment * SYNTH_SAMPLE_RATE / 65536.
+//
+// Przy 16 kHz na próbkę jest 1000 cykli. Koszt jednej próbki dla 1..4
+// głosów mierzy list_04/task_1 (synth_mix_1..4 i synth_sample_isr);
+// różnica między kolejnymi wierszami to koszt głosu.
+//
+// To samo przerwanie odlicza milisekundy (synth_milliseconds), na których
+// pętla główna może przełączać nuty.
+
+#ifndef SYNTH_VOICES
+#define SYNTH_VOICES 4
+#endif
+
+#ifndef SYNTH_SAMPLE_RATE
+#define SYNTH_SAMPLE_RATE 16000
+#endif
+
+#define SYNTH_INCREMENT(millihertz) \
+    ((uint16_t)(((millihertz)*65536ULL + 500ULL * SYNTH_SAMPLE_RATE) / (1000ULL * SYNTH_SAMPLE_RATE)))
+
+void synth_initialize(void); /* Uruchamia Timer1 i Timer2, włącza przerwania */
+void synth_stop(void);
+void synth_set_voice(uint8_t voice, uint16_t increment); /* 0 wycisza głos */
+uint16_t synth_milliseconds(void); /* Licznik milisekund z przerwania próbkowania */
+uint8_t synth_mix(uint8_t voices); /* Jedna próbka z pierwszych voices głosów (dla benchmarków) */
+
+#endif
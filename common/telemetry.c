@@ -0,0 +1,25 @@
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "uart.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+static uint8_t sequence = 0;
+static bool synchronized = false;
+
+bool telemetry_send(uint8_t type, const void* record, uint8_t size) {
+    uint8_t frame[TELEMETRY_MAX_ENCODED + 1];
+    // Przed pierwszą ramką wysyłamy separator, żeby odciąć ewentualny tekst
+    // wypisany wcześniej przez printf.
+    const uint8_t offset = synchronized ? 0 : 1;
+    frame[0] = 0;
+    const uint8_t length = telemetry_frame_encode(type, sequence, record, size, frame + offset) + offset;
+    // numer rośnie także dla porzuconych ramek, żeby dekoder widział stratę
+    sequence++;
+    if (length == offset || uart_bytes_free() < length) {
+        return false;
+    }
+    uart_write(frame, length);
+    synchronized = true;
+    return true;
+}
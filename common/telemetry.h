@@ -0,0 +1,18 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include "telemetry_records.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Binarny strumień telemetrii przez wspólny sterownik UART (uart.h).
+// Rekord jest kodowany do ramki (telemetry_frame.h) i w całości wrzucany do
+// bufora nadawczego; jeśli się nie mieści, to przepada, a luka jest widoczna
+// po stronie dekodera w numerach sekwencyjnych. Funkcja nigdy nie czeka.
+// Wołać tylko z pętli głównej -- bufor nadawczy ma jednego producenta.
+
+bool telemetry_send(uint8_t type, const void* record, uint8_t size);
+
+#define TELEMETRY_SEND(name, record) telemetry_send(TELEMETRY_##name, (record), sizeof(*(record)))
+
+#endif
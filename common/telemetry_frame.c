@@ -0,0 +1,116 @@
+#include "telemetry_frame.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __AVR__
+#include <util/crc16.h>
+#endif
+
+uint16_t telemetry_crc16_update(uint16_t crc, uint8_t data) {
+#ifdef __AVR__
+    return _crc_ccitt_update(crc, data);
+#else
+    // odpowiednik _crc_ccitt_update z avr-libc
+    data ^= crc & 0xff;
+    data ^= data << 4;
+    return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+#endif
+}
+
+uint8_t cobs_encode(const uint8_t* input, uint8_t length, uint8_t* output) {
+    // code_index wskazuje bajt, w który wpiszemy długość bieżącego bloku
+    uint8_t code_index = 0;
+    uint8_t output_index = 1;
+    uint8_t code = 1;
+    for (uint8_t index = 0; index < length; index++) {
+        const uint8_t data = input[index];
+        if (data == 0) {
+            output[code_index] = code;
+            code_index = output_index++;
+            code = 1;
+        } else {
+            output[output_index++] = data;
+            code++;
+            if (code == 0xff) {
+                output[code_index] = code;
+                code_index = output_index++;
+                code = 1;
+            }
+        }
+    }
+    output[code_index] = code;
+    return output_index;
+}
+
+uint8_t cobs_decode(const uint8_t* input, uint8_t length, uint8_t* output) {
+    uint8_t input_index = 0;
+    uint8_t output_index = 0;
+    while (input_index < length) {
+        const uint8_t code = input[input_index++];
+        if (code == 0 || input_index + code - 1 > length) {
+            return 0;
+        }
+        for (uint8_t index = 1; index < code; index++) {
+            const uint8_t data = input[input_index++];
+            if (data == 0) {
+                return 0;
+            }
+            output[output_index++] = data;
+        }
+        if (code != 0xff && input_index < length) {
+            output[output_index++] = 0;
+        }
+    }
+    return output_index;
+}
+
+uint8_t telemetry_frame_encode(uint8_t type, uint8_t sequence, const void* record, uint8_t size, uint8_t* output) {
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    if (size > TELEMETRY_MAX_RECORD) {
+        return 0;
+    }
+
+    frame[0] = type;
+    frame[1] = sequence;
+    memcpy(&frame[2], record, size);
+
+    uint16_t crc = 0xffff;
+    for (uint8_t index = 0; index < size + 2; index++) {
+        crc = telemetry_crc16_update(crc, frame[index]);
+    }
+    frame[size + 2] = crc & 0xff;
+    frame[size + 3] = crc >> 8;
+
+    const uint8_t length = cobs_encode(frame, size + TELEMETRY_FRAME_OVERHEAD, output);
+    output[length] = 0;
+    return length + 1;
+}
+
+bool telemetry_frame_decode(const uint8_t* input, uint8_t length, uint8_t* type, uint8_t* sequence,
+                            uint8_t* record, uint8_t* size) {
+    uint8_t frame[TELEMETRY_MAX_ENCODED];
+    if (length > TELEMETRY_MAX_ENCODED) {
+        return false;
+    }
+
+    const uint8_t frame_length = cobs_decode(input, length, frame);
+    if (frame_length < TELEMETRY_FRAME_OVERHEAD || frame_length > TELEMETRY_MAX_FRAME) {
+        return false;
+    }
+
+    // CRC policzone razem z dopisanym CRC daje 0
+    uint16_t crc = 0xffff;
+    for (uint8_t index = 0; index < frame_length; index++) {
+        crc = telemetry_crc16_update(crc, frame[index]);
+    }
+    if (crc != 0) {
+        return false;
+    }
+
+    *type = frame[0];
+    *sequence = frame[1];
+    *size = frame_length - TELEMETRY_FRAME_OVERHEAD;
+    memcpy(record, &frame[2], *size);
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef __TELEMETRY_FRAME_H
+#define __TELEMETRY_FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Ramka telemetrii przed kodowaniem:
+//     [typ][numer sekwencyjny][rekord ...][CRC16 lo][CRC16 hi]
+// CRC16 to CRC-CCITT odbity (wielomian 0x8408, start 0xFFFF), ten sam co
+// _crc_ccitt_update z avr-libc, liczony po typie, numerze i rekordzie.
+// Całość jest kodowana COBS, więc w środku nie ma bajtu 0, a ramkę kończy
+// pojedyncze 0x00. Odbiorca po zgubieniu bajtów synchronizuje się na
+// najbliższym zerze.
+//
+// Kod nie zależy od AVR, żeby ten sam plik kompilował się w dekoderze.
+
+#define TELEMETRY_MAX_RECORD 32
+#define TELEMETRY_FRAME_OVERHEAD 4 // typ, numer, CRC16
+#define TELEMETRY_MAX_FRAME (TELEMETRY_MAX_RECORD + TELEMETRY_FRAME_OVERHEAD)
+// COBS dokłada jeden bajt na każde rozpoczęte 254 bajty, plus separator
+#define TELEMETRY_MAX_ENCODED (TELEMETRY_MAX_FRAME + 2)
+
+uint16_t telemetry_crc16_update(uint16_t crc, uint8_t data);
+
+/* Koduje COBS; zwraca długość wyniku (bez separatora) */
+uint8_t cobs_encode(const uint8_t* input, uint8_t length, uint8_t* output);
+/* Dekoduje COBS w miejscu lub do output; zwraca długość albo 0 przy błędzie */
+uint8_t cobs_decode(const uint8_t* input, uint8_t length, uint8_t* output);
+
+/* Buduje kompletną ramkę z separatorem; zwraca jej długość */
+uint8_t telemetry_frame_encode(uint8_t type, uint8_t sequence, const void* record, uint8_t size, uint8_t* output);
+/* Sprawdza ramkę (bez separatora) i wyciąga z niej rekord */
+bool telemetry_frame_decode(const uint8_t* input, uint8_t length, uint8_t* type, uint8_t* sequence,
+                            uint8_t* record, uint8_t* size);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef __TELEMETRY_RECORDS_H
+#define __TELEMETRY_RECORDS_H
+
+#include <stdint.h>
+
+// Rejestr typów rekordów telemetrii. Plik jest wspólny dla firmware'u i
+// dekodera na Linuksie (tools/telemetry), więc układ struktur jest stały:
+// pola little-endian bez wyrównania (na AVR i tak go nie ma).
+//
+// Nowy rekord: dopisz strukturę i wiersz w TELEMETRY_RECORDS. Opis pól to
+// lista "nazwa:typ" (typy u8, i8, u16, i16, u32, i32) w kolejności pól
+// struktury; dekoder sprawdza, czy zgadza się z sizeof.
+
+typedef struct __attribute__((packed)) {
+    uint16_t timestamp;
+    uint8_t channel;
+    uint16_t adc;
+} telemetry_adc_sample_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t goal;
+    uint16_t adc;
+    int16_t output;
+} telemetry_pid_sample_t;
+
+#define TELEMETRY_RECORDS(RECORD)                                                    \
+    RECORD(0x01, adc_sample, telemetry_adc_sample_t, "timestamp:u16,channel:u8,adc:u16") \
+    RECORD(0x02, pid_sample, telemetry_pid_sample_t, "goal:u16,adc:u16,output:i16")
+
+#define TELEMETRY_RECORD_TYPE(id, name, type, fields) TELEMETRY_##name = id,
+enum { TELEMETRY_RECORDS(TELEMETRY_RECORD_TYPE) };
+#undef TELEMETRY_RECORD_TYPE
+
+#endif
@@ -0,0 +1,13 @@
+#include "thermistor.h"
+#include <avr/pgmspace.h>
+
+int16_t thermistor_decycelsius(const int16_t* table, uint16_t adc) {
+    if (adc > 1023) {
+        adc = 1023;
+    }
+    const uint16_t index = adc >> THERMISTOR_TABLE_SHIFT;
+    const uint8_t fraction = adc & (THERMISTOR_TABLE_STEP - 1);
+    const int16_t low = pgm_read_word(&table[index]);
+    const int16_t high = pgm_read_word(&table[index + 1]);
+    return low + (int16_t)(((int32_t)(high - low) * fraction) >> THERMISTOR_TABLE_SHIFT);
+}
@@ -0,0 +1,29 @@
+#ifndef __THERMISTOR_H
+#define __THERMISTOR_H
+
+#include <stdint.h>
+
+// Przeliczanie kodu ADC termistora na temperaturę bez log() i float.
+//
+// Tablica w pamięci flash zawiera temperaturę [d°C] dla co 16. kodu ADC
+// (0, 16, ..., 1024), pomiędzy nimi wynik jest interpolowany liniowo. Gdy
+// krzywa jest stroma (np. termistor na źródle prądowym przy małych kodach),
+// można zagęścić tablicę, kompilując z -DTHERMISTOR_TABLE_SHIFT=2 (co 4.
+// kod, 514 bajtów flash).
+// Tablicę dla konkretnego układu (dzielnik albo źródło prądowe, stałe
+// R0, T0, B) generuje narzędzie tools/thermistor, np.:
+//     ./thermistor divider 5.0 4400 4700 298.15 3206.64 > thermistor_table.h
+//
+// Koszt to dwa odczyty z flash i jedno mnożenie 16x16, więc funkcję można
+// wołać w ADC_vect przy każdej próbce.
+
+#ifndef THERMISTOR_TABLE_SHIFT
+#define THERMISTOR_TABLE_SHIFT 4
+#endif
+#define THERMISTOR_TABLE_STEP (1 << THERMISTOR_TABLE_SHIFT)
+#define THERMISTOR_TABLE_SIZE ((1024 >> THERMISTOR_TABLE_SHIFT) + 1)
+
+/* table -- tablica THERMISTOR_TABLE_SIZE wartości w PROGMEM, adc -- 0..1023 */
+int16_t thermistor_decycelsius(const int16_t* table, uint16_t adc);
+
+#endif
@@ -0,0 +1,204 @@
+#include "timer_wheel.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <stddef.h>
+#include <util/atomic.h>
+
+#define LEVEL_BITS 5
+#define LEVEL_SIZE (1 << LEVEL_BITS)
+#define LEVEL_MASK (LEVEL_SIZE - 1)
+#define LEVELS 3
+// najdalszy takt, który mieści się w kole bez ponownego przenoszenia
+#define MAX_DELTA (((uint32_t)1 << (LEVEL_BITS * LEVELS)) - 1)
+
+// Preskaler Timer2 dobrany tak, żeby takt zmieścił się w 8-bitowym OCR2A.
+#define TICK_COUNTS(prescaler) ((F_CPU / 1000000UL) * TIMER_WHEEL_TICK_US / (prescaler))
+#if TICK_COUNTS(1) <= 256
+#define PRESCALER_BITS _BV(CS20)
+#define PRESCALER 1
+#elif TICK_COUNTS(8) <= 256
+#define PRESCALER_BITS _BV(CS21)
+#define PRESCALER 8
+#elif TICK_COUNTS(32) <= 256
+#define PRESCALER_BITS (_BV(CS21) | _BV(CS20))
+#define PRESCALER 32
+#elif TICK_COUNTS(64) <= 256
+#define PRESCALER_BITS _BV(CS22)
+#define PRESCALER 64
+#elif TICK_COUNTS(128) <= 256
+#define PRESCALER_BITS (_BV(CS22) | _BV(CS20))
+#define PRESCALER 128
+#elif TICK_COUNTS(256) <= 256
+#define PRESCALER_BITS (_BV(CS22) | _BV(CS21))
+#define PRESCALER 256
+#elif TICK_COUNTS(1024) <= 256
+#define PRESCALER_BITS (_BV(CS22) | _BV(CS21) | _BV(CS20))
+#define PRESCALER 1024
+#else
+#error "TIMER_WHEEL_TICK_US too long for Timer2"
+#endif
+
+static timer_wheel_timer_t* wheel[LEVELS][LEVEL_SIZE];
+static timer_wheel_timer_t* volatile pending = NULL;
+static volatile uint32_t now = 0;
+
+static void link(timer_wheel_timer_t** head, timer_wheel_timer_t* timer) {
+    timer->next = *head;
+    if (timer->next != NULL) {
+        timer->next->previous = &timer->next;
+    }
+    timer->previous = head;
+    *head = timer;
+}
+
+static void unlink(timer_wheel_timer_t* timer) {
+    *timer->previous = timer->next;
+    if (timer->next != NULL) {
+        timer->next->previous = timer->previous;
+    }
+    timer->next = NULL;
+    timer->previous = NULL;
+}
+
+// Wkłada timer do slotu według odległości do wygaśnięcia. Woła się przy
+// zablokowanych przerwaniach.
+static void place(timer_wheel_timer_t* timer) {
+    const uint32_t delta = timer->expires - now;
+    if ((int32_t)delta <= 0) {
+        // już po czasie (np. okresowy, którego callback trwał za długo)
+        link((timer_wheel_timer_t**)&pending, timer);
+    } else if (delta < LEVEL_SIZE) {
+        link(&wheel[0][timer->expires & LEVEL_MASK], timer);
+    } else if (delta < ((uint32_t)1 << (2 * LEVEL_BITS))) {
+        link(&wheel[1][(timer->expires >> LEVEL_BITS) & LEVEL_MASK], timer);
+    } else if (delta <= MAX_DELTA) {
+        link(&wheel[2][(timer->expires >> (2 * LEVEL_BITS)) & LEVEL_MASK], timer);
+    } else {
+        // poza zasięgiem koła: slot, który zostanie przeniesiony przed
+        // wygaśnięciem, tam odległość zostanie policzona od nowa
+        link(&wheel[2][((now + MAX_DELTA) >> (2 * LEVEL_BITS)) & LEVEL_MASK], timer);
+    }
+}
+
+// Rozkłada slot wyższego poziomu na niższe.
+static void cascade(uint8_t level, uint8_t index) {
+    timer_wheel_timer_t* timer = wheel[level][index];
+    wheel[level][index] = NULL;
+    while (timer != NULL) {
+        timer_wheel_timer_t* next = timer->next;
+        timer->previous = NULL;
+        place(timer);
+        timer = next;
+    }
+}
+
+ISR(TIMER2_COMPA_vect) {
+    const uint32_t tick = now + 1;
+    now = tick;
+    const uint8_t index = tick & LEVEL_MASK;
+    if (index == 0) {
+        cascade(1, (tick >> LEVEL_BITS) & LEVEL_MASK);
+        if (((tick >> LEVEL_BITS) & LEVEL_MASK) == 0) {
+            cascade(2, (tick >> (2 * LEVEL_BITS)) & LEVEL_MASK);
+        }
+    }
+    // wygasłe timery na listę oczekujących
+    timer_wheel_timer_t* timer = wheel[0][index];
+    wheel[0][index] = NULL;
+    while (timer != NULL) {
+        timer_wheel_timer_t* next = timer->next;
+        link((timer_wheel_timer_t**)&pending, timer);
+        timer = next;
+    }
+}
+
+void timer_wheel_initialize(void) {
+    // ustaw tryb licznika
+    // WGM2  = 010 -- CTC, TOP = OCR2A
+    TCCR2A = _BV(WGM21);
+    TCCR2B = PRESCALER_BITS;
+    OCR2A = TICK_COUNTS(PRESCALER) - 1;
+    TCNT2 = 0;
+    TIMSK2 = _BV(OCIE2A);
+    sei();
+}
+
+uint32_t timer_wheel_now(void) {
+    uint32_t result;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        result = now;
+    }
+    return result;
+}
+
+void timer_wheel_start(timer_wheel_timer_t* timer, uint32_t delay, uint32_t period, timer_wheel_callback_t callback,
+                       void* context) {
+    if (delay == 0) {
+        delay = 1;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (timer->previous != NULL) {
+            unlink(timer);
+        }
+        timer->period = period;
+        timer->callback = callback;
+        timer->context = context;
+        timer->expires = now + delay;
+        place(timer);
+    }
+}
+
+void timer_wheel_cancel(timer_wheel_timer_t* timer) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (timer->previous != NULL) {
+            unlink(timer);
+        }
+    }
+}
+
+bool timer_wheel_is_active(const timer_wheel_timer_t* timer) {
+    bool active;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        active = timer->previous != NULL;
+    }
+    return active;
+}
+
+bool timer_wheel_dispatch(void) {
+    bool dispatched = false;
+    while (1) {
+        timer_wheel_timer_t* timer;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            timer = pending;
+            if (timer != NULL) {
+                unlink(timer);
+                // okresowy wraca do koła przed callbackiem, żeby callback
+                // mógł go anulować; kolejne wygaśnięcie liczymy od
+                // poprzedniego, więc okres nie dryfuje
+                if (timer->period != 0) {
+                    timer->expires += timer->period;
+                    place(timer);
+                }
+            }
+        }
+        if (timer == NULL) {
+            return dispatched;
+        }
+        timer->callback(timer->context);
+        dispatched = true;
+    }
+}
+
+void timer_wheel_sleep(void) {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    if (pending == NULL) {
+        // sei tuż przed sleep_cpu: przerwanie nie zginie między nimi
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+    sei();
+}
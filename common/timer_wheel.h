@@ -0,0 +1,62 @@
+#ifndef __TIMER_WHEEL_H
+#define __TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Programowe timery (jednorazowe i okresowe) na jednym sprzętowym Timer2.
+//
+// Timer2 w trybie CTC generuje przerwanie co TIMER_WHEEL_TICK_US. Timery
+// czekają w hierarchicznym kole: 3 poziomy po 32 sloty, poziom 0 to
+// najbliższe 32 takty, poziom 1 -- 1024, poziom 2 -- 32768; dalsze timery
+// są przenoszone w dół, kiedy przyjdzie ich kolej. Wstawienie i anulowanie
+// to O(1) (lista dwukierunkowa w slocie), przerwanie obsługuje jeden slot
+// na takt i co 32 takty przenosi jeden slot z wyższego poziomu.
+//
+// Przerwanie tylko przekłada wygasłe timery na listę oczekujących, a
+// callbacki wykonuje timer_wheel_dispatch() w pętli głównej, więc mogą
+// używać printf, UART itd. Typowa pętla:
+//     static timer_wheel_timer_t blink;
+//     timer_wheel_initialize();
+//     timer_wheel_start(&blink, TIMER_WHEEL_MS(500), TIMER_WHEEL_MS(500), toggle_led, NULL);
+//     while (1) {
+//         if (!timer_wheel_dispatch()) {
+//             timer_wheel_sleep(); // SLEEP_MODE_IDLE do następnego przerwania
+//         }
+//     }
+//
+// Rozdzielczość to jeden takt: opóźnienie jest zaokrąglane w górę do
+// pełnych taktów, a callback startuje po wybudzeniu pętli głównej. Krótszy
+// takt (np. 100 us) daje mikrosekundową rozdzielczość kosztem częstszego
+// przerwania; dla pojedynczych impulsów krótszych niż takt dalej trzeba
+// sprzętowego timera albo _delay_us.
+
+#ifndef TIMER_WHEEL_TICK_US
+#define TIMER_WHEEL_TICK_US 1000
+#endif
+
+#define TIMER_WHEEL_US(us) (((uint32_t)(us) + TIMER_WHEEL_TICK_US - 1) / TIMER_WHEEL_TICK_US)
+#define TIMER_WHEEL_MS(ms) TIMER_WHEEL_US((uint32_t)(ms) * 1000)
+
+typedef void (*timer_wheel_callback_t)(void* context);
+
+typedef struct timer_wheel_timer {
+    struct timer_wheel_timer* next;
+    struct timer_wheel_timer** previous; // pole next poprzednika albo głowa listy; NULL gdy nieaktywny
+    uint32_t expires; // takt, w którym timer wygasa
+    uint32_t period; // 0 dla jednorazowego
+    timer_wheel_callback_t callback;
+    void* context;
+} timer_wheel_timer_t;
+
+void timer_wheel_initialize(void); /* Uruchamia Timer2 i włącza przerwania */
+uint32_t timer_wheel_now(void);    /* Liczba taktów od inicjalizacji */
+/* (Re)startuje timer: pierwszy raz po delay taktach (min. 1), potem co period (0 -- raz) */
+void timer_wheel_start(timer_wheel_timer_t* timer, uint32_t delay, uint32_t period, timer_wheel_callback_t callback,
+                       void* context);
+void timer_wheel_cancel(timer_wheel_timer_t* timer); /* Zatrzymuje timer, także już wygasły */
+bool timer_wheel_is_active(const timer_wheel_timer_t* timer);
+bool timer_wheel_dispatch(void); /* Wykonuje wygasłe callbacki, false gdy nie było żadnego */
+void timer_wheel_sleep(void);    /* Usypia (SLEEP_MODE_IDLE), jeśli nic nie czeka; włącza przerwania */
+
+#endif
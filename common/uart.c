@@ -0,0 +1,109 @@
+#include "uart.h"
+#include "ring_buffer.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
+
+#define UART_BUFFER_SIZE 128
+
+RING_BUFFER_CREATE(receiver, uint8_t, UART_BUFFER_SIZE);
+RING_BUFFER_CREATE(transmitter, uint8_t, UART_BUFFER_SIZE);
+
+#define ENABLE_DATA_REGISTER_EMPTY_INTERRUPT UCSR0B |= _BV(UDRIE0)
+#define DISABLE_DATA_REGISTER_EMPTY_INTERRUPT UCSR0B &= ~_BV(UDRIE0)
+
+// czy od startu cokolwiek nadano; bez tego uart_flush czekałby na TXC0,
+// które po resecie się nie ustawi
+static bool transmitted = false;
+
+// Kasuje TXC0 (zapisując 1) - ustawi się dopiero, gdy nowe dane wyjdą
+// z rejestru przesuwnego - i włącza przerwanie nadawania.
+static inline void start_transmission(void) {
+    transmitted = true;
+    UCSR0A |= _BV(TXC0);
+    ENABLE_DATA_REGISTER_EMPTY_INTERRUPT;
+}
+
+void uart_initialize(void) {
+    // ustaw baudrate
+    UBRR0 = UBRR_VALUE;
+    // wyczyść rejestr UCSR0A
+    UCSR0A = 0;
+    // włącz odbiornik i nadajnik oraz przerwanie od odbioru
+    UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+    // ustaw format 8n1
+    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
+}
+
+// Receive Complete Interrupt
+ISR(USART_RX_vect) {
+    // przy pełnym buforze znak przepada
+    receiver_write(UDR0);
+}
+
+// Data Register Empty Interrupt
+ISR(USART_UDRE_vect) {
+    uint8_t data;
+    if (transmitter_read(&data)) {
+        UDR0 = data;
+    } else {
+        // Jeśli nic więcej nie ma w buforze to wyłączamy przerwanie, żeby nie
+        // obciążało programu (to przerwanie zaczyna wykonywać się przez cały
+        // czas kiedy rejestr jest pusty).
+        DISABLE_DATA_REGISTER_EMPTY_INTERRUPT;
+    }
+}
+
+// Bufory są typu jeden producent / jeden konsument, więc nie trzeba wyłączać
+// przerwań na czas dopisywania do bufora nadawczego.
+int uart_transmit(char data, FILE* stream) {
+    // czekaj aż zwolni się miejsce w buforze
+    while (!transmitter_write(data)) { }
+    start_transmission();
+    return 0;
+}
+
+int uart_receive(FILE* stream) {
+    // czekaj aż znak dostępny
+    uint8_t result;
+    while (!receiver_read(&result)) { }
+    return result;
+}
+
+uint8_t uart_write(const uint8_t* data, uint8_t length) {
+    const uint8_t written = transmitter_write_n(data, length);
+    if (written > 0) {
+        start_transmission();
+    }
+    return written;
+}
+
+bool uart_try_read(uint8_t* data) {
+    return receiver_read(data);
+}
+
+uint8_t uart_bytes_free(void) {
+    return transmitter_free();
+}
+
+uint8_t uart_bytes_available(void) {
+    return receiver_count();
+}
+
+void uart_flush(void) {
+    while (!transmitter_is_empty()) { }
+    // ostatni bajt może jeszcze być w UDR0 albo w rejestrze przesuwnym
+    if (transmitted) {
+        loop_until_bit_is_set(UCSR0A, TXC0);
+    }
+}
+
+static FILE uart_file;
+
+void uart_setup_stdio(void) {
+    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
+    stdin = stdout = stderr = &uart_file;
+}
@@ -0,0 +1,26 @@
+#ifndef __UART_H
+#define __UART_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Sterownik UART oparty na przerwaniach. Nadawanie i odbiór idą przez bufory
+// cykliczne obsługiwane w USART_UDRE_vect i USART_RX_vect, więc printf nie
+// czeka na wysłanie każdego znaku (przy 9600 bodów to ~1 ms na bajt).
+
+#ifndef BAUD
+#define BAUD 9600 // baudrate
+#endif
+
+void uart_initialize(void);                          /* Ustawia baudrate, format 8n1 i przerwania */
+void uart_setup_stdio(void);                         /* Podpina stdin/stdout/stderr pod UART */
+int uart_transmit(char data, FILE* stream);          /* Blokujący zapis (czeka na miejsce w buforze) */
+int uart_receive(FILE* stream);                      /* Blokujący odczyt (czeka na znak w buforze) */
+uint8_t uart_write(const uint8_t* data, uint8_t length); /* Nieblokujący zapis, zwraca liczbę zapisanych bajtów */
+bool uart_try_read(uint8_t* data);                   /* Nieblokujący odczyt, false gdy bufor pusty */
+uint8_t uart_bytes_free(void);                       /* Wolne miejsce w buforze nadawczym */
+uint8_t uart_bytes_available(void);                  /* Liczba bajtów czekających w buforze odbiorczym */
+void uart_flush(void);                               /* Czeka aż ostatni bajt wyjdzie z nadajnika */
+
+#endif
@@ -1,37 +1,9 @@
+#include "uart.h"
+#include <avr/interrupt.h>
 #include <avr/io.h>
 #include <inttypes.h>
 #include <stdio.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // wyczyść rejestr UCSR0A
-    UCSR0A = 0;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0))) { }
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0))) { }
-    return UDR0;
-}
-
 #define PRINT_OPERATION(print_format, operation_result, operation_string)                      \
     printf("%" print_format " " operation_string " %" print_format " = %" print_format "\r\n", \
         first, second, operation_result)
@@ -104,14 +76,13 @@ void handle_type(uint8_t type) {
     }
 }
 
-FILE uart_file;
-
 int main() {
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
+    // nadawanie i odbiór działają na przerwaniach
+    sei();
 
     while (1) {
         printf("Wybierz typ danych:\r\n");
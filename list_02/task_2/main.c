@@ -1,39 +1,9 @@
+#include "timer_wheel.h"
+#include "uart.h"
 #include <avr/io.h>
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
-#include <util/delay.h>
-
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // wyczyść rejestr UCSR0A
-    UCSR0A = 0;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0))) { }
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0))) { }
-    return UDR0;
-}
-
-FILE uart_file;
 
 #define BUTTON_PORT PORTC
 #define BUTTON_PIN PINC
@@ -45,6 +15,24 @@ FILE uart_file;
 
 #define TICK_TIME 10 // 10 ms
 
+// Takty co TICK_TIME z timer_wheel zamiast _delay_ms: między taktami
+// procesor śpi, a takty nie rozjeżdżają się o czas obsługi przycisku.
+static timer_wheel_timer_t tick_timer;
+static bool ticked = false;
+
+static void on_tick(void* context) {
+    ticked = true;
+}
+
+static void wait_tick(void) {
+    while (!ticked) {
+        if (!timer_wheel_dispatch()) {
+            timer_wheel_sleep();
+        }
+    }
+    ticked = false;
+}
+
 #define MASK_GET(mask, bit) ((mask)&_BV(bit))
 #define MASK_SET(mask, bit) (mask) |= _BV(bit)
 #define MASK_UNSET(mask, bit) (mask) &= ~_BV(bit)
@@ -52,7 +40,7 @@ FILE uart_file;
 #define HANDLE_BUTTON_PRESSED(handler)          \
     /* przycisk 1 -> pin 0, maska 0 */          \
     if (!MASK_GET(BUTTON_PIN | mask, BUTTON)) { \
-        _delay_ms(TICK_TIME);                   \
+        wait_tick();                            \
         INCREASE_COUNTER(1);                    \
         /* czy pin nadal jest zgaszony */       \
         if (!MASK_GET(BUTTON_PIN, BUTTON)) {    \
@@ -64,7 +52,7 @@ FILE uart_file;
 #define HANDLE_BUTTON_HELD(handler)                     \
     /* przycisk 1 -> pin 0, maska 1 */                  \
     if (MASK_GET((BUTTON_PIN ^ mask) & mask, BUTTON)) { \
-        _delay_ms(TICK_TIME);                           \
+        wait_tick();                                    \
         INCREASE_COUNTER(1);                            \
         /* czy pin nadal jest zgaszony */               \
         if (!MASK_GET(BUTTON_PIN, BUTTON)) {            \
@@ -75,7 +63,7 @@ FILE uart_file;
 #define HANDLE_BUTTON_RELEASED(handler)        \
     /* przycisk 0 -> pin 1, maska 1 */         \
     if (MASK_GET(BUTTON_PIN & mask, BUTTON)) { \
-        _delay_ms(TICK_TIME);                  \
+        wait_tick();                           \
         INCREASE_COUNTER(1);                   \
         /* czy pin nadal jest zapalony */      \
         if (MASK_GET(BUTTON_PIN, BUTTON)) {    \
@@ -87,7 +75,7 @@ FILE uart_file;
 #define HANDLE_BUTTON_STILL(handler)                          \
     /* przycisk 0 -> pin 1, maska 0 */                        \
     if (MASK_GET((BUTTON_PIN ^ mask) & BUTTON_PIN, BUTTON)) { \
-        _delay_ms(TICK_TIME);                                 \
+        wait_tick();                                          \
         INCREASE_COUNTER(1);                                  \
         /* czy pin nadal jest zapalony */                     \
         if (MASK_GET(BUTTON_PIN, BUTTON)) {                   \
@@ -191,16 +179,18 @@ static char morse_letter_to_character(uint8_t letter) {
 
 int main() {
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
 
     LED_DDR |= _BV(LED);
     LED_PORT &= ~_BV(LED);
 
     BUTTON_PORT |= _BV(BUTTON);
 
+    timer_wheel_initialize();
+    timer_wheel_start(&tick_timer, TIMER_WHEEL_MS(TICK_TIME), TIMER_WHEEL_MS(TICK_TIME), on_tick, NULL);
+
     char text_buffer[256];
     uint8_t text_buffer_length = 0;
 
@@ -282,7 +272,7 @@ int main() {
                 text_buffer_length = 0;
             })
 
-        _delay_ms(TICK_TIME);
+        wait_tick();
         INCREASE_COUNTER(1);
     }
 }
@@ -1,13 +1,29 @@
+#include "melody_decoder.h"
+#include "sequencer.h"
+#include "synth.h"
 #include <avr/io.h>
 #include <avr/pgmspace.h>
-#include <util/delay.h>
+#include <avr/sleep.h>
 
 #define DISABLE_UNCOMMON_PITCHES
 #undef DISABLE_UNCOMMON_PITCHES
 
-#define BUZZ PC0
-#define BUZZ_DDR DDRC
-#define BUZZ_PORT PORTC
+#define SYNTHESIS
+#undef SYNTHESIS
+
+// melodia z song.h (song.txt skompresowany przez tools/melody) zamiast melody[]
+#define COMPRESSED_MELODY
+#undef COMPRESSED_MELODY
+
+#ifdef SYNTHESIS
+// głośnik przez filtr RC na OC2A (PB3), trzy głosy syntezy tablicowej
+// (common/synth): melodia, ta sama melodia oktawę niżej i kanon opóźniony
+// o całą nutę
+#define PITCH(frequency) SYNTH_INCREMENT(frequency)
+#else
+// brzęczyk na OC1A (PB1), przełączany sprzętowo przez Timer1 (common/sequencer)
+#define PITCH(frequency) SEQUENCER_TOP(frequency)
+#endif
 
 #define LED PB5
 #define LED_DDR DDRB
@@ -101,179 +117,52 @@ enum pitch {
 #define B5_FREQUENCY 987767
 #endif
 
-static const uint32_t pitch_to_frequency[] = {
+// TOP Timer1 albo przyrost fazy dla każdej wysokości, liczony w czasie kompilacji
+static const uint16_t pitch_to_value[] PROGMEM = {
 #ifndef DISABLE_UNCOMMON_PITCHES
-    C3_FREQUENCY,
-    CS3_FREQUENCY,
-    D3_FREQUENCY,
-    DS3_FREQUENCY,
-    E3_FREQUENCY,
-    F3_FREQUENCY,
-    FS3_FREQUENCY,
-    G3_FREQUENCY,
-    GS3_FREQUENCY,
-    A3_FREQUENCY,
-    AS3_FREQUENCY,
-    B3_FREQUENCY,
+    PITCH(C3_FREQUENCY),
+    PITCH(CS3_FREQUENCY),
+    PITCH(D3_FREQUENCY),
+    PITCH(DS3_FREQUENCY),
+    PITCH(E3_FREQUENCY),
+    PITCH(F3_FREQUENCY),
+    PITCH(FS3_FREQUENCY),
+    PITCH(G3_FREQUENCY),
+    PITCH(GS3_FREQUENCY),
+    PITCH(A3_FREQUENCY),
+    PITCH(AS3_FREQUENCY),
+    PITCH(B3_FREQUENCY),
 #endif
 
-    C4_FREQUENCY,
-    CS4_FREQUENCY,
-    D4_FREQUENCY,
-    DS4_FREQUENCY,
-    E4_FREQUENCY,
-    F4_FREQUENCY,
-    FS4_FREQUENCY,
-    G4_FREQUENCY,
-    GS4_FREQUENCY,
-    A4_FREQUENCY,
-    AS4_FREQUENCY,
-    B4_FREQUENCY,
-
-    C5_FREQUENCY,
-    CS5_FREQUENCY,
-    D5_FREQUENCY,
+    PITCH(C4_FREQUENCY),
+    PITCH(CS4_FREQUENCY),
+    PITCH(D4_FREQUENCY),
+    PITCH(DS4_FREQUENCY),
+    PITCH(E4_FREQUENCY),
+    PITCH(F4_FREQUENCY),
+    PITCH(FS4_FREQUENCY),
+    PITCH(G4_FREQUENCY),
+    PITCH(GS4_FREQUENCY),
+    PITCH(A4_FREQUENCY),
+    PITCH(AS4_FREQUENCY),
+    PITCH(B4_FREQUENCY),
+
+    PITCH(C5_FREQUENCY),
+    PITCH(CS5_FREQUENCY),
+    PITCH(D5_FREQUENCY),
 #ifndef DISABLE_UNCOMMON_PITCHES
-    DS5_FREQUENCY,
-    E5_FREQUENCY,
-    F5_FREQUENCY,
-    FS5_FREQUENCY,
-    G5_FREQUENCY,
-    GS5_FREQUENCY,
-    A5_FREQUENCY,
-    AS5_FREQUENCY,
-    B5_FREQUENCY,
+    PITCH(DS5_FREQUENCY),
+    PITCH(E5_FREQUENCY),
+    PITCH(F5_FREQUENCY),
+    PITCH(FS5_FREQUENCY),
+    PITCH(G5_FREQUENCY),
+    PITCH(GS5_FREQUENCY),
+    PITCH(A5_FREQUENCY),
+    PITCH(AS5_FREQUENCY),
+    PITCH(B5_FREQUENCY),
 #endif
 };
 
-#define DELAY_US(pitch) _delay_us(1000000000 / (pitch) / 2)
-
-static void pitch_as_delay(enum pitch pitch) {
-    switch (pitch) {
-#ifndef DISABLE_UNCOMMON_PITCHES
-    case C3:
-        DELAY_US(C3_FREQUENCY);
-        break;
-    case CS3:
-        DELAY_US(CS3_FREQUENCY);
-        break;
-    case D3:
-        DELAY_US(D3_FREQUENCY);
-        break;
-    case DS3:
-        DELAY_US(DS3_FREQUENCY);
-        break;
-    case E3:
-        DELAY_US(E3_FREQUENCY);
-        break;
-    case F3:
-        DELAY_US(F3_FREQUENCY);
-        break;
-    case FS3:
-        DELAY_US(FS3_FREQUENCY);
-        break;
-    case G3:
-        DELAY_US(G3_FREQUENCY);
-        break;
-    case GS3:
-        DELAY_US(GS3_FREQUENCY);
-        break;
-    case A3:
-        DELAY_US(A3_FREQUENCY);
-        break;
-    case AS3:
-        DELAY_US(AS3_FREQUENCY);
-        break;
-    case B3:
-        DELAY_US(B3_FREQUENCY);
-        break;
-#endif
-
-    case C4:
-        DELAY_US(C4_FREQUENCY);
-        break;
-    case CS4:
-        DELAY_US(CS4_FREQUENCY);
-        break;
-    case D4:
-        DELAY_US(D4_FREQUENCY);
-        break;
-    case DS4:
-        DELAY_US(DS4_FREQUENCY);
-        break;
-    case E4:
-        DELAY_US(E4_FREQUENCY);
-        break;
-    case F4:
-        DELAY_US(F4_FREQUENCY);
-        break;
-    case FS4:
-        DELAY_US(FS4_FREQUENCY);
-        break;
-    case G4:
-        DELAY_US(G4_FREQUENCY);
-        break;
-    case GS4:
-        DELAY_US(GS4_FREQUENCY);
-        break;
-    case A4:
-        DELAY_US(A4_FREQUENCY);
-        break;
-    case AS4:
-        DELAY_US(AS4_FREQUENCY);
-        break;
-    case B4:
-        DELAY_US(B4_FREQUENCY);
-        break;
-
-    case C5:
-        DELAY_US(C5_FREQUENCY);
-        break;
-    case CS5:
-        DELAY_US(CS5_FREQUENCY);
-        break;
-    case D5:
-        DELAY_US(D5_FREQUENCY);
-        break;
-#ifndef DISABLE_UNCOMMON_PITCHES
-    case DS5:
-        DELAY_US(DS5_FREQUENCY);
-        break;
-    case E5:
-        DELAY_US(E5_FREQUENCY);
-        break;
-    case F5:
-        DELAY_US(F5_FREQUENCY);
-        break;
-    case FS5:
-        DELAY_US(FS5_FREQUENCY);
-        break;
-    case G5:
-        DELAY_US(G5_FREQUENCY);
-        break;
-    case GS5:
-        DELAY_US(GS5_FREQUENCY);
-        break;
-    case A5:
-        DELAY_US(A5_FREQUENCY);
-        break;
-    case AS5:
-        DELAY_US(AS5_FREQUENCY);
-        break;
-    case B5:
-        DELAY_US(B5_FREQUENCY);
-        break;
-#endif
-
-    default:
-        // nieprawidłowa wysokość dźwięku
-        LED_PORT |= _BV(LED);
-        _delay_ms(1000);
-        LED_PORT &= ~_BV(LED);
-        break;
-    }
-}
-
 enum duration {
     WHOLE,
     WHOLE_DOT,
@@ -321,7 +210,8 @@ enum duration {
 #define HUNDRED_TWENTY_EIGHTH_LENGTH SIXTY_FOURTH_LENGTH / 2
 #define HUNDRED_TWENTY_EIGHTH_DOT_LENGTH HUNDRED_TWENTY_EIGHTH_LENGTH + HUNDRED_TWENTY_EIGHTH_LENGTH / 2
 
-static const uint16_t duration_to_length[] = {
+#ifndef COMPRESSED_MELODY
+static const uint16_t duration_to_length[] PROGMEM = {
     WHOLE_LENGTH,
     WHOLE_DOT_LENGTH,
     HALF_LENGTH,
@@ -340,85 +230,6 @@ static const uint16_t duration_to_length[] = {
     HUNDRED_TWENTY_EIGHTH_DOT_LENGTH,
 };
 
-static void duration_as_delay(enum duration duration) {
-    switch (duration) {
-    case WHOLE:
-        _delay_ms(WHOLE_LENGTH);
-        break;
-    case WHOLE_DOT:
-        _delay_ms(WHOLE_DOT_LENGTH);
-        break;
-    case HALF:
-        _delay_ms(HALF_LENGTH);
-        break;
-    case HALF_DOT:
-        _delay_ms(HALF_DOT_LENGTH);
-        break;
-    case QUARTER:
-        _delay_ms(QUARTER_LENGTH);
-        break;
-    case QUARTER_DOT:
-        _delay_ms(QUARTER_DOT_LENGTH);
-        break;
-    case EIGHT:
-        _delay_ms(EIGHT_LENGTH);
-        break;
-    case EIGHT_DOT:
-        _delay_ms(EIGHT_DOT_LENGTH);
-        break;
-    case SIXTEENTH:
-        _delay_ms(SIXTEENTH_LENGTH);
-        break;
-    case SIXTEENTH_DOT:
-        _delay_ms(SIXTEENTH_DOT_LENGTH);
-        break;
-    case THIRTY_SECOND:
-        _delay_ms(THIRTY_SECOND_LENGTH);
-        break;
-    case THIRTY_SECOND_DOT:
-        _delay_ms(THIRTY_SECOND_DOT_LENGTH);
-        break;
-    case SIXTY_FOURTH:
-        _delay_ms(SIXTY_FOURTH_LENGTH);
-        break;
-    case SIXTY_FOURTH_DOT:
-        _delay_ms(SIXTY_FOURTH_DOT_LENGTH);
-        break;
-    case HUNDRED_TWENTY_EIGHTH:
-        _delay_ms(HUNDRED_TWENTY_EIGHTH_LENGTH);
-        break;
-    case HUNDRED_TWENTY_EIGHTH_DOT:
-        _delay_ms(HUNDRED_TWENTY_EIGHTH_DOT_LENGTH);
-        break;
-
-    default:
-        // nieprawidłowy czas trwania dźwięku
-        LED_PORT |= _BV(LED);
-        _delay_ms(333);
-        LED_PORT &= ~_BV(LED);
-        _delay_ms(333);
-        LED_PORT |= _BV(LED);
-        _delay_ms(333);
-        LED_PORT &= ~_BV(LED);
-        break;
-    }
-}
-
-inline static void play_note(enum pitch pitch, enum duration duration) {
-    uint32_t frequency = pitch_to_frequency[pitch];
-    uint16_t length = duration_to_length[duration];
-    for (uint32_t index = 0; index < (uint32_t)frequency * length / 1000000; index++) {
-        BUZZ_PORT |= _BV(BUZZ);
-        pitch_as_delay(pitch);
-        BUZZ_PORT &= ~_BV(BUZZ);
-        pitch_as_delay(pitch);
-    }
-}
-
-inline static void play_rest(enum duration duration) {
-    duration_as_delay(duration);
-}
-
 #ifdef DISABLE_UNCOMMON_PITCHES
 // kodowanie 15 wysokości + pauza i 16 długości
 #define NOTE(pitch, duration) ((pitch << 4) | duration),
@@ -588,25 +399,156 @@ static const uint8_t melody[] PROGMEM = {
 #define MELODY_SIZE sizeof(melody) / 2
 #endif
 
-int main() {
-    BUZZ_DDR |= _BV(BUZZ);
-    LED_DDR |= _BV(LED);
+#endif
 
-    while (1) {
-        for (uint8_t index = 0; index < MELODY_SIZE; index++) {
+#define PITCHES_COUNT (sizeof(pitch_to_value) / sizeof(pitch_to_value[0]))
+
+#ifdef COMPRESSED_MELODY
+
+#include "song.h"
+
+// numer MIDI pierwszej wysokości w pitch_to_value
 #ifdef DISABLE_UNCOMMON_PITCHES
-            uint8_t note = pgm_read_byte(&melody[index]);
-            enum pitch pitch = (note & 0xF0) >> 4;
-            enum duration duration = note & 0x0F;
+#define FIRST_PITCH 60 // C4
 #else
-            enum pitch pitch = pgm_read_byte(&melody[2 * index]);
-            enum duration duration = pgm_read_byte(&melody[2 * index + 1]);
+#define FIRST_PITCH 48 // C3
 #endif
-            if (pitch == REST_PITCH) {
-                play_rest(duration);
-            } else {
-                play_note(pitch, duration);
+
+typedef melody_decoder_t cursor_t;
+
+static void rewind_melody(cursor_t* cursor) {
+    melody_decoder_initialize(cursor, song);
+}
+
+// Odczytuje kolejną nutę; value = 0 oznacza pauzę.
+static bool read_note(cursor_t* cursor, uint16_t* value, uint16_t* length) {
+    melody_note_t note;
+    if (!melody_decoder_next(cursor, &note)) {
+        return false;
+    }
+    uint8_t pitch = note.pitch;
+    if (pitch != MELODY_SILENCE && (pitch < FIRST_PITCH || pitch - FIRST_PITCH >= PITCHES_COUNT)) {
+        // wysokość spoza tablicy: zapal diodę i zagraj pauzę
+        LED_PORT |= _BV(LED);
+        pitch = MELODY_SILENCE;
+    }
+    *value = pitch == MELODY_SILENCE ? 0 : pgm_read_word(&pitch_to_value[pitch - FIRST_PITCH]);
+    *length = (uint32_t)note.length * WHOLE_LENGTH / MELODY_WHOLE;
+    return true;
+}
+
+#else
+
+#define DURATIONS_COUNT (sizeof(duration_to_length) / sizeof(duration_to_length[0]))
+
+typedef uint16_t cursor_t;
+
+static void rewind_melody(cursor_t* cursor) {
+    *cursor = 0;
+}
+
+// Odczytuje kolejną nutę; value = 0 oznacza pauzę.
+static bool read_note(cursor_t* cursor, uint16_t* value, uint16_t* length) {
+    const uint16_t index = *cursor;
+    if (index >= MELODY_SIZE) {
+        return false;
+    }
+    (*cursor)++;
+#ifdef DISABLE_UNCOMMON_PITCHES
+    uint8_t packed = pgm_read_byte(&melody[index]);
+    uint8_t pitch = (packed & 0xF0) >> 4;
+    uint8_t duration = packed & 0x0F;
+#else
+    uint8_t pitch = pgm_read_byte(&melody[2 * index]);
+    uint8_t duration = pgm_read_byte(&melody[2 * index + 1]);
+#endif
+
+    if ((pitch != REST_PITCH && pitch >= PITCHES_COUNT) || duration >= DURATIONS_COUNT) {
+        // nieprawidłowa nuta: zapal diodę i zagraj pauzę
+        LED_PORT |= _BV(LED);
+        pitch = REST_PITCH;
+        duration = QUARTER;
+    }
+    *value = pitch == REST_PITCH ? 0 : pgm_read_word(&pitch_to_value[pitch]);
+    *length = pgm_read_word(&duration_to_length[duration]);
+    return true;
+}
+
+#endif
+
+#ifdef SYNTHESIS
+
+typedef struct {
+    cursor_t cursor;
+    uint16_t deadline; // milisekunda startu następnej nuty
+} track_t;
+
+// ścieżka 0 gra głosy 0 i 1 (oktawę niżej), ścieżka 1 głos 2
+static track_t tracks[2];
+
+static void advance(uint8_t track) {
+    uint16_t increment;
+    uint16_t length;
+    if (!read_note(&tracks[track].cursor, &increment, &length)) {
+        rewind_melody(&tracks[track].cursor);
+        read_note(&tracks[track].cursor, &increment, &length);
+    }
+    // kolejna nuta liczy się od poprzedniego terminu, więc opóźnienie
+    // pętli głównej nie rozjeżdża kanonu
+    tracks[track].deadline += length;
+    if (track == 0) {
+        synth_set_voice(0, increment);
+        synth_set_voice(1, increment >> 1);
+    } else {
+        synth_set_voice(2, increment);
+    }
+}
+
+int main() {
+    LED_DDR |= _BV(LED);
+    synth_initialize();
+
+    const uint16_t start = synth_milliseconds();
+    rewind_melody(&tracks[0].cursor);
+    tracks[0].deadline = start;
+    rewind_melody(&tracks[1].cursor);
+    tracks[1].deadline = start + WHOLE_LENGTH;
+
+    // budzi nas przerwanie próbkowania, więc wystarczy sprawdzać terminy
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (1) {
+        const uint16_t now = synth_milliseconds();
+        for (uint8_t track = 0; track < 2; track++) {
+            if ((int16_t)(now - tracks[track].deadline) >= 0) {
+                advance(track);
             }
         }
+        sleep_mode();
     }
 }
+
+#else
+
+static cursor_t cursor;
+
+// Źródło nut dla sekwencera, wołane z przerwania na końcu każdej nuty.
+static bool next_note(sequencer_note_t* note) {
+    return read_note(&cursor, &note->top, &note->milliseconds);
+}
+
+int main() {
+    LED_DDR |= _BV(LED);
+    sequencer_initialize();
+
+    // pętla główna tylko wznawia melodię; między przerwaniami śpi
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (1) {
+        if (!sequencer_is_playing()) {
+            rewind_melody(&cursor);
+            sequencer_play(next_note);
+        }
+        sleep_mode();
+    }
+}
+
+#endif
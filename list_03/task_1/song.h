@@ -0,0 +1,29 @@
+#ifndef __SONG_H
+#define __SONG_H
+
+// Wygenerowane przez tools/melody: 195 nut w 192 bajtach.
+
+#include "melody_decoder.h"
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+static const uint8_t song[] PROGMEM = {
+    0x69, 0x40, 0x81, 0x60, 0x20, 0x80, 0x02, 0x60, 0x10, 0x80, 0x03, 0x60,
+    0x10, 0x1E, 0x22, 0x80, 0x20, 0x83, 0x02, 0x3C, 0x11, 0x60, 0x40, 0x80,
+    0x20, 0x63, 0x40, 0x1D, 0x1E, 0x1E, 0x5D, 0x20, 0x80, 0x02, 0x60, 0x20,
+    0x22, 0x21, 0x1D, 0x83, 0x02, 0x3C, 0x27, 0x68, 0x40, 0x81, 0x60, 0x20,
+    0x80, 0x08, 0x60, 0x10, 0x80, 0x02, 0x60, 0x10, 0x1E, 0x62, 0x20, 0x80,
+    0x02, 0x60, 0x40, 0x80, 0x30, 0x83, 0x02, 0x46, 0x13, 0x63, 0x40, 0x5D,
+    0x20, 0x81, 0x5E, 0x40, 0x5E, 0x20, 0x81, 0x1D, 0x80, 0x08, 0x60, 0x20,
+    0x22, 0x21, 0x1D, 0x83, 0x02, 0x3E, 0x2C, 0x1D, 0x1D, 0x1E, 0x19, 0x64,
+    0x60, 0x5F, 0x30, 0x60, 0x20, 0x60, 0x40, 0x62, 0x20, 0x20, 0x60, 0x40,
+    0x62, 0x20, 0x20, 0x60, 0x40, 0x5D, 0x30, 0x68, 0x20, 0x1D, 0x23, 0x14,
+    0x64, 0x60, 0x5F, 0x20, 0x20, 0x60, 0x40, 0x62, 0x20, 0x20, 0x60, 0x40,
+    0x62, 0x20, 0x20, 0x60, 0x40, 0x5C, 0x20, 0x29, 0x1D, 0x1E, 0x22, 0x17,
+    0x64, 0x60, 0x5F, 0x20, 0x20, 0x60, 0x40, 0x62, 0x20, 0x20, 0x60, 0x40,
+    0x62, 0x20, 0x20, 0x60, 0x40, 0x5C, 0x20, 0x29, 0x1D, 0x1E, 0x19, 0x6C,
+    0x60, 0x60, 0x20, 0x60, 0x40, 0x18, 0x68, 0x20, 0x60, 0x60, 0x59, 0x40,
+    0x67, 0x20, 0x60, 0x60, 0x5B, 0x40, 0x6A, 0x20, 0x1B, 0x65, 0x40, 0xFF,
+};
+
+#endif
@@ -1,10 +1,11 @@
-#include <util/delay.h>
+#include "soft_pwm.h"
+#include "uart.h"
 #include <avr/io.h>
 #include <inttypes.h>
+#include <stdio.h>
+#include <util/delay.h>
 
 #define LED PB5
-#define LED_DDR DDRB
-#define LED_PORT PORTB
 
 // inicjalizacja ADC
 void adc_init() {
@@ -23,38 +24,33 @@ inline static uint16_t read_adc() {
     return ADC; // weź zmierzoną wartość (0..1023)
 }
 
-// ```julia
-// using Pipe
-// @pipe range(0, 9, length=128) |>
-// map(x -> trunc(Int, floor(exp(x))) - 1, _) |>
-// foreach(x -> print("$x, "), _)
-// ```
-static const uint16_t exponential_table[] = {
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 6, 6, 7, 7,
-    8, 9, 10, 10, 11, 12, 13, 14, 16, 17, 18, 20, 21, 23, 25, 26, 29, 31, 33, 36, 38, 41, 44, 48,
-    51, 55, 59, 64, 69, 74, 79, 85, 92, 99, 106, 114, 122, 131, 141, 152, 163, 175, 188, 202, 217,
-    233, 250, 269, 288, 310, 332, 357, 383, 412, 442, 474, 509, 547, 587, 630, 677, 727, 780, 838,
-    899, 965, 1036, 1113, 1194, 1282, 1376, 1478, 1586, 1703, 1828, 1962, 2107, 2261, 2428, 2606,
-    2797, 3003, 3224, 3461, 3715, 3988, 4281, 4595, 4933, 5295, 5684, 6101, 6550, 7031, 7547, 8102
-};
+// Jasność diody z potencjometru. PWM robi przerwanie Timer1
+// (common/soft_pwm), a krzywą jasności daje jego tablica gamma zamiast
+// exponential_table i pętli z _delay_us(1).
 
 int main() {
+    uart_initialize();
+    uart_setup_stdio();
     adc_init();
-    LED_DDR |= _BV(LED);
+    soft_pwm_initialize();
+    const uint8_t led = soft_pwm_add_channel(SOFT_PWM_PORT_B, LED);
 
+    uint8_t brightness = 0;
+    uint16_t reported_cycles = 0;
+    soft_pwm_commit();
     while (1) {
-        uint16_t adc = read_adc();
-        const uint16_t adc_maximum_value = 1024;
-        const uint16_t exponential_length = sizeof(exponential_table) / 2;
-        uint16_t iterations = exponential_table[adc / (adc_maximum_value / exponential_length)];
-        LED_PORT |= _BV(LED);
-        for (uint16_t index = 0; index < iterations; index++) {
-            _delay_us(1);
+        const uint8_t adc_brightness = read_adc() >> 2;
+        if (adc_brightness != brightness) {
+            brightness = adc_brightness;
+            soft_pwm_set(led, brightness);
+            soft_pwm_commit();
         }
-        LED_PORT &= ~_BV(LED);
-        const uint16_t maximum_iterations = exponential_table[sizeof(exponential_table) / 2 - 1];
-        for (uint16_t index = 0; index < maximum_iterations - iterations; index++) {
-            _delay_us(1);
+
+        const uint16_t cycles = soft_pwm_worst_case_cycles();
+        if (cycles != reported_cycles) {
+            reported_cycles = cycles;
+            printf("Worst case ISR: %" PRIu16 " cycles\r\n", cycles);
         }
+        _delay_ms(10);
     }
 }
@@ -1,3 +1,8 @@
+#include "fixed_format.h"
+#include "thermistor.h"
+#include "thermistor_table.h"
+#include "uart.h"
+#include <avr/interrupt.h>
 #include <avr/io.h>
 #include <inttypes.h>
 #include <stdio.h>
@@ -7,36 +12,6 @@
 #define LED_DDR DDRB
 #define LED_PORT PORTB
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
 // inicjalizacja ADC
 void adc_init() {
     ADMUX = _BV(REFS0); // referencja AVcc = 5V, pomiar ADC0
@@ -47,8 +22,6 @@ void adc_init() {
     ADCSRA |= _BV(ADEN); // włącz ADC
 }
 
-FILE uart_file;
-
 // T = ~20.8 C = 293.95 K
 
 // ADC = V_in * 1024 / V_ref
@@ -65,10 +38,11 @@ FILE uart_file;
 
 int main() {
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
+    // nadawanie i odbiór działają na przerwaniach
+    sei();
     // zainicjalizuj ADC
     adc_init();
     LED_DDR |= _BV(LED);
@@ -81,16 +55,11 @@ int main() {
         LED_PORT |= _BV(LED);
         uint16_t adc = ADC; // weź zmierzoną wartość (0..1023)
         // printf("%" PRIu16 "\r\n", adc);
-        const float vref = 5;
-        float termistor_voltage = (adc * vref) / 1024;
-        const float resistor_resistance = 4400;
-        float termistor_resistance = termistor_voltage * resistor_resistance / (vref - termistor_voltage);
-        const float T_0 = 298.15;
-        const float R_0 = 4700;
-        const float termistor_constant = 3206.637682344697;
-        float temperature = termistor_constant / (log(termistor_resistance / R_0) + (termistor_constant / T_0));
-        float temperature_celsius = temperature - 273.15;
-        printf("Odczytano: %f°C\r\n", temperature_celsius);
+        // temperatura z tablicy wygenerowanej dla R = 4400, R_0 = 4700,
+        // T_0 = 298.15 K, B = 3206.64 (tools/thermistor)
+        char text[12];
+        format_decycelsius(text, sizeof(text), thermistor_decycelsius(thermistor_table, adc));
+        printf("Odczytano: %s°C\r\n", text);
         _delay_ms(1000);
     }
 }
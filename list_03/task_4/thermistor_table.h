@@ -0,0 +1,29 @@
+#ifndef __THERMISTOR_TABLE_H
+#define __THERMISTOR_TABLE_H
+
+// Wygenerowane przez tools/thermistor:
+//     divider 5.0 4400 4700 298.15 3206.637682344697
+// Maksymalny błąd interpolacji w zakresie 0..1000 d°C: 1.41 d°C.
+
+#include "thermistor.h"
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+#if THERMISTOR_TABLE_SHIFT != 4
+#error "table generated for -DTHERMISTOR_TABLE_SHIFT=4"
+#endif
+
+// temperatura [d°C] dla ADC = 0, 16, ..., 1024
+static const int16_t thermistor_table[THERMISTOR_TABLE_SIZE] PROGMEM = {
+    1500, 1500, 1500, 1445, 1286, 1169, 1077, 1001,
+    936, 880, 830, 786, 745, 708, 674, 642,
+    612, 584, 557, 532, 507, 484, 462, 440,
+    419, 399, 379, 360, 341, 322, 304, 286,
+    268, 251, 234, 217, 199, 183, 166, 149,
+    132, 114, 97, 80, 62, 44, 26, 8,
+    -11, -31, -51, -72, -93, -116, -140, -166,
+    -194, -224, -257, -294, -338, -391, -461, -550,
+    -550,
+};
+
+#endif
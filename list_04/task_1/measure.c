@@ -1,35 +1,35 @@
+#include "benchmark.h"
+#include "fixed_format.h"
+#include "melody_decoder.h"
+#include "pid.h"
+#include "random.h"
+#include "synth.h"
 #include <avr/io.h>
 #include <inttypes.h>
+#include <stdio.h>
 
-uint16_t measure_empty(void) {
-    uint16_t start_time = TCNT1;
-    uint16_t end_time = TCNT1;
-    return end_time - start_time;
-}
+// Argumenty są volatile, żeby kompilator nie policzył wyniku w czasie
+// kompilacji. Koszt samego odczytu argumentów i zapisu wyniku pokazuje
+// wiersz assign_<typ>, który należy odjąć od add/mul/div.
+
+#define DEFINE_ARGUMENTS(type)                     \
+    static volatile type left_##type = 123; \
+    static volatile type right_##type = 45;
 
-#define DEFINE_EMPTY_ASSIGNMENT(type)                \
-    uint16_t measure_empty_assignment_##type(type argument) { \
-        uint16_t start_time = TCNT1;                 \
-        volatile type _ = argument;                         \
-        uint16_t end_time = TCNT1;                   \
-        return end_time - start_time;                \
+#define DEFINE_EMPTY_ASSIGNMENT(type)                        \
+    BENCHMARK(assign_##type) {                               \
+        volatile type _ = left_##type;                       \
+        (void)right_##type;                                  \
     }
 
-DEFINE_EMPTY_ASSIGNMENT(int8_t);
-DEFINE_EMPTY_ASSIGNMENT(int16_t);
-DEFINE_EMPTY_ASSIGNMENT(int32_t);
-DEFINE_EMPTY_ASSIGNMENT(int64_t);
-DEFINE_EMPTY_ASSIGNMENT(float);
-
-#define DEFINE_OPERATION_FUNCTION(name, operation, type)      \
-    uint16_t measure_##name##_##type(type left, type right) { \
-        uint16_t start_time = TCNT1;                          \
-        volatile type _ = left operation right;               \
-        uint16_t end_time = TCNT1;                            \
-        return end_time - start_time;                         \
+#define DEFINE_OPERATION_FUNCTION(name, operation, type)     \
+    BENCHMARK(name##_##type) {                               \
+        volatile type _ = left_##type operation right_##type; \
     }
 
 #define DEFINE_OPERATIONS_FUNCTIONS(type)    \
+    DEFINE_ARGUMENTS(type);                  \
+    DEFINE_EMPTY_ASSIGNMENT(type);           \
     DEFINE_OPERATION_FUNCTION(add, +, type); \
     DEFINE_OPERATION_FUNCTION(mul, *, type); \
     DEFINE_OPERATION_FUNCTION(div, /, type);
@@ -39,3 +39,126 @@ DEFINE_OPERATIONS_FUNCTIONS(int16_t);
 DEFINE_OPERATIONS_FUNCTIONS(int32_t);
 DEFINE_OPERATIONS_FUNCTIONS(int64_t);
 DEFINE_OPERATIONS_FUNCTIONS(float);
+
+static char format_buffer[16];
+static volatile int32_t format_milivolts_argument = 1234;
+static volatile float format_volts_argument = 1.234;
+
+BENCHMARK(format_fixed) {
+    format_milivolts(format_buffer, sizeof(format_buffer), format_milivolts_argument, 3);
+}
+
+BENCHMARK(format_float) {
+    snprintf(format_buffer, sizeof(format_buffer), "%.3f", format_volts_argument);
+}
+
+// Synteza (common/synth): jedna próbka z 1..4 głosów. Różnica między
+// kolejnymi wierszami to koszt głosu, a synth_sample_isr to całe przerwanie
+// próbkowania (SYNTH_VOICES głosów z wejściem i wyjściem). Przy
+// SYNTH_SAMPLE_RATE = 16 kHz na próbkę jest F_CPU / 16000 = 1000 cykli.
+#define DEFINE_SYNTH_MIX(voices)                 \
+    BENCHMARK(synth_mix_##voices) {              \
+        volatile uint8_t _ = synth_mix(voices);  \
+    }
+
+DEFINE_SYNTH_MIX(1);
+DEFINE_SYNTH_MIX(2);
+DEFINE_SYNTH_MIX(3);
+DEFINE_SYNTH_MIX(4);
+
+// procedura obsługi przerwania kończy się reti, więc da się ją wywołać wprost
+void TIMER1_COMPA_vect(void);
+
+BENCHMARK(synth_sample_isr) {
+    TIMER1_COMPA_vect();
+}
+
+// Dekoder melodii (common/melody_decoder): jedna nuta na wywołanie. Pętla
+// zawiera nutę z długością, dwie nuty bez długości, pauzę z dwubajtową
+// długością i powtórzenie, więc min to najtańsza nuta, a max nuta
+// poprzedzona skokiem powtórzenia.
+static const uint8_t benchmark_melody[] PROGMEM = {
+    MELODY_NOTE | MELODY_DELTA(2), MELODY_WHOLE / 4,
+    MELODY_NOTE_SAME | MELODY_DELTA(-2),
+    MELODY_REST, 0x80, 0x01,
+    MELODY_NOTE_SAME | MELODY_DELTA(0),
+    MELODY_REPEAT, 0, 60, 7,
+};
+static melody_decoder_t benchmark_decoder;
+static melody_note_t benchmark_note;
+
+BENCHMARK(melody_next_note) {
+    if (benchmark_decoder.data == 0) {
+        melody_decoder_initialize(&benchmark_decoder, benchmark_melody);
+    }
+    melody_decoder_next(&benchmark_decoder, &benchmark_note);
+}
+
+// Generator liczb losowych (common/random): random_byte to średnio jedna
+// czwarta kroku xorshift32 (max to krok, min wydanie bajtu z zapasu),
+// random_range dla bound = 6 to przeważnie jedno losowanie i mnożenie.
+static volatile uint16_t random_bound = 6;
+
+BENCHMARK(random_byte) {
+    volatile uint8_t _ = random_byte();
+}
+
+BENCHMARK(random_u32) {
+    volatile uint32_t _ = random_u32();
+}
+
+BENCHMARK(random_range) {
+    volatile uint16_t _ = random_range(random_bound);
+}
+
+// Regulator PID (common/pid): jeden krok ze wszystkimi członami, filtrem
+// pochodnej i back-calculation. Wynik dotyczy formatu wzmocnień z DEFS
+// (domyślnie Q16.16; -DPID_GAIN_FRACTION_BITS=8 mierzy Q8.8). Przy PWM
+// 977 Hz na okres, a więc na ADC_vect, przypada około 16000 cykli.
+static pid_controller_t benchmark_pid = {
+    .parameters = {
+        .kp = PID_GAIN(3.9),
+        .ki = PID_GAIN(0.05),
+        .kd = PID_GAIN(0.012),
+        .kt = PID_GAIN(0.0128),
+        .setpoint_weight_p = PID_GAIN(0.8),
+        .setpoint_weight_d = 0,
+        .derivative_filter_shift = 2,
+        .output_min = -128,
+        .output_max = 128,
+    },
+};
+static volatile int16_t pid_setpoint = 512;
+static volatile int16_t pid_measurement = 480;
+
+BENCHMARK(pid_update) {
+    volatile int16_t _ = pid_update(&benchmark_pid, pid_setpoint, pid_measurement);
+}
+
+#define OPERATIONS_ENTRIES(type)          \
+    BENCHMARK_ENTRY(assign_##type),       \
+        BENCHMARK_ENTRY(add_##type),      \
+        BENCHMARK_ENTRY(mul_##type),      \
+        BENCHMARK_ENTRY(div_##type)
+
+const benchmark_t benchmarks[] = {
+    OPERATIONS_ENTRIES(int8_t),
+    OPERATIONS_ENTRIES(int16_t),
+    OPERATIONS_ENTRIES(int32_t),
+    OPERATIONS_ENTRIES(int64_t),
+    OPERATIONS_ENTRIES(float),
+    BENCHMARK_ENTRY(format_fixed),
+    BENCHMARK_ENTRY(format_float),
+    BENCHMARK_ENTRY(synth_mix_1),
+    BENCHMARK_ENTRY(synth_mix_2),
+    BENCHMARK_ENTRY(synth_mix_3),
+    BENCHMARK_ENTRY(synth_mix_4),
+    BENCHMARK_ENTRY(synth_sample_isr),
+    BENCHMARK_ENTRY(melody_next_note),
+    BENCHMARK_ENTRY(random_byte),
+    BENCHMARK_ENTRY(random_u32),
+    BENCHMARK_ENTRY(random_range),
+    BENCHMARK_ENTRY(pid_update),
+};
+
+const uint8_t benchmarks_count = sizeof(benchmarks) / sizeof(benchmarks[0]);
@@ -1,71 +1,59 @@
+#include "ir_proximity.h"
+#include "ir_remote.h"
+#include "uart.h"
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/sleep.h>
+#include <stdio.h>
+
+// zamiast czujnika zbliżeniowego dekoduj piloty (NEC, RC5) z tego samego
+// odbiornika i wypisuj klawisze na UART
+#undef REMOTE
 
 #define LED PB5
 #define LED_DDR DDRB
 #define LED_PORT PORTB
 
-#define DETECTOR PB0
-#define DETECTOR_PIN PINB
-#define DETECTOR_PORT PORTB
+// Dioda IR na OC1A (PB1), odbiornik 38 kHz na PB0. Paczki nośnej i próbkowanie
+// odbiornika działają w przerwaniach (common/ir_proximity), a pętla główna
+// tylko przepisuje decyzję na diodę co ramkę (100 ms).
 
-#define ENABLE_TIMER \
-    TCCR1A |= _BV(COM1A1)
+#ifdef REMOTE
+static const char* const protocol_names[] = { "NEC", "RC5" };
 
-#define DISABLE_TIMER \
-    TCCR1A &= ~_BV(COM1A1)
+int main() {
+    LED_DDR |= _BV(LED);
+    uart_initialize();
+    uart_setup_stdio();
+    ir_remote_initialize();
 
-void initialize_timer() {
-    // ustaw tryb licznika
-    // COM1A = 10   -- non-inverting mode
-    // WGM1  = 1110 -- fast PWM top=ICR1
-    // CS1   = 001  -- prescaler 1
-    // ICR1  = 421
-    // częstotliwość 16e6/(1024*(1+15624)) = 1 Hz
-    // wzór: datasheet 20.12.3 str. 164
-    ICR1 = 421;
-    TCCR1A = _BV(COM1A1) | _BV(WGM11);
-    TCCR1B = _BV(WGM12) | _BV(WGM13) | _BV(CS10);
-    // ustaw pin OC1A (PB1) jako wyjście
-    DDRB |= _BV(PB1);
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (1) {
+        ir_remote_key_t key;
+        while (ir_remote_read(&key)) {
+            printf("%s %04X %02X%s\r\n", protocol_names[key.protocol], key.address, key.command,
+                   key.repeat ? " R" : "");
+            LED_PORT ^= _BV(LED);
+        }
+        sleep_mode();
+    }
 }
-
+#else
 int main() {
-    DETECTOR_PORT |= _BV(DETECTOR);
     LED_DDR |= _BV(LED);
-    initialize_timer();
-    // ustaw wypełnienie 50%
-    OCR1A = ICR1 / 2;
+    ir_proximity_initialize();
 
+    // ustaw tryb uśpienia na tryb bezczynności
+    set_sleep_mode(SLEEP_MODE_IDLE);
     while (1) {
-        for (uint8_t index = 0; index < 5; index++) {
-            ENABLE_TIMER;
-
-            _delay_us(600);
-
-            if (DETECTOR_PIN & _BV(DETECTOR)) {
-                LED_PORT &= ~_BV(LED);
-            } else {
+        ir_proximity_result_t result;
+        if (ir_proximity_update(&result)) {
+            if (result.detected) {
                 LED_PORT |= _BV(LED);
+            } else {
+                LED_PORT &= ~_BV(LED);
             }
-
-            DISABLE_TIMER;
-
-            _delay_us(600);
         }
-
-        ENABLE_TIMER;
-        
-        _delay_us(600);
-
-        if (DETECTOR_PIN & _BV(DETECTOR)) {
-            LED_PORT &= ~_BV(LED);
-        } else {
-            LED_PORT |= _BV(LED);
-        }
-
-        DISABLE_TIMER;
-
-        _delay_us(100000 - (2 * 600 * 5 + 600));
+        sleep_mode();
     }
 }
+#endif
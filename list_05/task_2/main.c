@@ -1,3 +1,4 @@
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <avr/sleep.h>
@@ -5,40 +6,6 @@
 #include <stdlib.h>
 #include <util/delay.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // wyczyść rejestr UCSR0A
-    UCSR0A = 0;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
-FILE uart_file;
-
 static void initialize_adc() {
     ADMUX = _BV(REFS0); // referencja AVcc = 5V, pomiar ADC0
     DIDR0 = _BV(ADC0D); // wyłącz wejście cyfrowe na ADC0
@@ -76,10 +43,11 @@ ISR(ADC_vect) {
 
 int main() {
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
+    // nadawanie i odbiór działają na przerwaniach
+    sei();
 
     initialize_adc();
     initialize_io();
@@ -1,43 +1,19 @@
+#include "adc_oversample.h"
+#include "fixed_format.h"
+#include "fixed_math.h"
+#include "running_stats.h"
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <avr/sleep.h>
 #include <stdio.h>
+#include <util/atomic.h>
 #include <util/delay.h>
 
 #define LED PB5
 #define LED_DDR DDRB
 #define LED_PORT PORTB
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
 // inicjalizacja ADC
 static void initialize_adc() {
     ADMUX = _BV(REFS0); // referencja AVcc
@@ -48,68 +24,116 @@ static void initialize_adc() {
     ADCSRA |= _BV(ADEN); // włącz ADC
 }
 
-ISR(ADC_vect) {
-}
-
-FILE uart_file;
+// liczba dodatkowych bitów przy nadpróbkowaniu (4^n próbek na wynik)
+#define OVERSAMPLING_BITS 3
 
-#define MEASUREMENTS 255
+// liczba próbek w jednej serii (przy ~9600 konwersjach/s to ok. 7 s);
+// przy nadpróbkowaniu seria ma 4^n razy mniej wyników
+#define SAMPLES 65536UL
+#define OVERSAMPLED_SAMPLES (SAMPLES >> (2 * OVERSAMPLING_BITS))
 
-static float measurements[MEASUREMENTS] = { 0 };
+static running_stats_t stats;
+static adc_oversample_t oversample;
+static volatile uint8_t oversampling_enabled = 0;
+static volatile uint8_t collecting = 0;
+static uint32_t samples_target;
 
-static float calculate_average() {
-    float average = 0;
-    for (uint8_t index = 0; index < MEASUREMENTS; index++) {
-        average += measurements[index];
+ISR(ADC_vect) {
+    uint16_t sample = ADC;
+    if (oversampling_enabled) {
+        if (!adc_oversample_add(&oversample, sample)) {
+            return;
+        }
+        sample = oversample.result;
+    }
+    if (collecting) {
+        running_stats_add(&stats, sample);
+        if (stats.count == samples_target) {
+            collecting = 0;
+        }
     }
-    return average / MEASUREMENTS;
 }
 
-#define SQUARE(x) x * x
-
-static float calculate_variance() {
-    float average = calculate_average();
-    float variance = 0;
-    for (uint8_t index = 0; index < MEASUREMENTS; index++) {
-        variance += SQUARE(measurements[index] - average);
-    }
-    return average / MEASUREMENTS;
+// rozpocznij serię zbieraną w przerwaniu
+static void start_collecting(uint32_t samples) {
+    running_stats_reset(&stats);
+    samples_target = samples;
+    collecting = 1;
 }
 
-#define MAKE_MEASUREMENTS(trigger)                           \
-    for (uint8_t index = 0; index < MEASUREMENTS; index++) { \
-        trigger;                                             \
-        uint16_t adc = ADC;                                  \
-        const float vin = 1.1;                               \
-        float vref = (vin * 1024) / adc;                     \
-        measurements[index] = vref;                          \
+// Wypisuje statystyki serii. Mierzymy 1.1V względem AVcc, więc
+// vref = 1.1 * resolution / kod; szum vref w uV liczymy z odchylenia kodu
+// (d vref / d kod = vref / kod).
+static void print_noise_floor(const char* name, uint32_t resolution) {
+    running_stats_t snapshot;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        snapshot = stats;
     }
+    const float mean = running_stats_mean(&snapshot);
+    const float variance = running_stats_variance(&snapshot);
+    const uint16_t deviation_centi_lsb = fixed_sqrt32(variance * 1e4);
+    const float vref = 1.1 * resolution / mean;
+    const uint32_t deviation_microvolts = vref * 1e4 * deviation_centi_lsb / mean;
+
+    char mean_text[12];
+    char deviation_text[12];
+    char vref_text[12];
+    format_fixed(mean_text, sizeof(mean_text), mean * 100, 2, 2);
+    format_fixed(deviation_text, sizeof(deviation_text), deviation_centi_lsb, 2, 2);
+    format_milivolts(vref_text, sizeof(vref_text), vref * 1e6, 3);
+    printf("%s: n=%" PRIu32 " mean=%s [%" PRIu16 "..%" PRIu16 "] sd=%s LSB, vref=%s mV, noise floor: %"
+           PRIu32 " uV\r\n",
+           name, snapshot.count, mean_text, snapshot.min, snapshot.max, deviation_text, vref_text,
+           deviation_microvolts);
+}
 
 int main() {
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
+    // nadawanie i odbiór działają na przerwaniach
+    sei();
     // zainicjalizuj ADC
     initialize_adc();
 
     while (1) {
+        // nadajnik UART nie może pracować w trakcie pomiaru szumu, a w trybie
+        // ADC noise reduction zegar I/O stoi i przerwałby nadawany bajt
+        uart_flush();
         ADCSRA &= ~_BV(ADIE);
-        MAKE_MEASUREMENTS(
+        running_stats_reset(&stats);
+        for (uint32_t index = 0; index < SAMPLES; index++) {
             ADCSRA |= _BV(ADSC);
             loop_until_bit_is_set(ADCSRA, ADIF);
-            ADCSRA |= _BV(ADIF););
-        float adc_variance = calculate_variance(measurements);
+            ADCSRA |= _BV(ADIF);
+            running_stats_add(&stats, ADC);
+        }
+        print_noise_floor("        Polling", 1024);
+        uart_flush();
 
         ADCSRA |= _BV(ADIE); // ADC Interrupt Enable
         set_sleep_mode(SLEEP_MODE_ADC);
         sei();
-        MAKE_MEASUREMENTS(sleep_mode(););
-        float adc_noise_reduction_variance = calculate_variance(measurements);
-
-        printf("                Variance: %f\r\n", adc_variance);
-        printf("Noise reduction variance: %f\r\n\n", adc_noise_reduction_variance);
+        start_collecting(SAMPLES);
+        while (collecting) {
+            sleep_mode();
+        }
+        print_noise_floor("Noise reduction", 1024);
+        uart_flush();
+
+        // ADC w trybie free running, przerwanie sumuje 4^n próbek
+        adc_oversample_initialize(&oversample, OVERSAMPLING_BITS);
+        oversampling_enabled = 1;
+        start_collecting(OVERSAMPLED_SAMPLES);
+        ADCSRB &= ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0)); // free running
+        ADCSRA |= _BV(ADATE) | _BV(ADSC);
+        while (collecting) { }
+        ADCSRA &= ~_BV(ADATE);
+        loop_until_bit_is_clear(ADCSRA, ADSC);
+        oversampling_enabled = 0;
+        print_noise_floor("   Oversampling", (uint32_t)1024 << OVERSAMPLING_BITS);
+        printf("\r\n");
 
         _delay_ms(1000);
     }
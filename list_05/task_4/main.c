@@ -1,96 +1,59 @@
+#include "fixed_format.h"
+#include "frequency_meter.h"
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <avr/sleep.h>
+#include <inttypes.h>
 #include <stdio.h>
-#include <util/delay.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // wyczyść rejestr UCSR0A
-    UCSR0A = 0;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
-// oczekiwanie na zakończenie transmisji
-void uart_wait() {
-    while (!(UCSR0A & _BV(TXC0)))
-        ;
-}
-
-FILE uart_file;
-
-#define TOP 15624
-
-static void initialize_timer_1() {
+// Sygnał testowy: Timer2 na OC2B (PD3), ~100 Hz, wypełnienie 25%.
+// Połącz PD3 z wejściami miernika: ICP1 (PB0) i T1 (PD5).
+static void initialize_timer_2() {
     // ustaw tryb licznika
-    // COM1A = 10   -- non-inverting mode
-    // WGM1  = 1111 -- fast PWM top=OCR1A
-    // CS1   = 101  -- prescaler 1024
-    // ICR1  = 15624
-    // częstotliwość 16e6/(1024*(1+15624)) = 1 Hz
-    OCR1A = TOP;
-    TCCR1A = _BV(COM1A1) | _BV(WGM11) | _BV(WGM10);
-    TCCR1B = _BV(WGM12) | _BV(WGM13) | _BV(CS12) | _BV(CS10);
-    // odmaskowanie przerwania input capture
-    TIMSK1 |= _BV(ICIE1);
+    // COM2B = 10  -- non-inverting mode
+    // WGM2  = 111 -- fast PWM top=OCR2A
+    // CS2   = 111 -- prescaler 1024
+    // częstotliwość 16e6/(1024*(1+155)) = 100.16 Hz
+    OCR2A = 155;
+    OCR2B = 38;
+    TCCR2A = _BV(COM2B1) | _BV(WGM21) | _BV(WGM20);
+    TCCR2B = _BV(WGM22) | _BV(CS22) | _BV(CS21) | _BV(CS20);
+    DDRD |= _BV(PD3);
 }
 
-static volatile uint16_t last_timestamp = 0;
-static volatile uint8_t last_period = 1;
-
-ISR(TIMER1_CAPT_vect) {
-    uint16_t timestamp = ICR1;
-    last_period = timestamp - last_timestamp;
-    last_timestamp = timestamp;
+static void print_result(const frequency_meter_result_t* result) {
+    char frequency[16];
+    format_fixed(frequency, sizeof(frequency), result->frequency_centihertz, 2, 2);
+    if (result->mode == FREQUENCY_METER_GATED) {
+        printf("Frequency: %s Hz (gated, %" PRIu32 " edges)\r\n", frequency, result->count);
+        return;
+    }
+    char duty[8];
+    format_fixed(duty, sizeof(duty), result->duty_permille, 1, 1);
+    printf("Frequency: %s Hz, period: %" PRIu32 " cycles, duty: %s%%, jitter: %" PRIu32
+           " cycles (%" PRIu32 " periods, %" PRIu8 " lost)\r\n",
+           frequency, result->period_cycles, duty, result->jitter_cycles, result->count, result->overruns);
 }
 
 int main() {
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
 
-    initialize_timer_1();
+    initialize_timer_2();
+    frequency_meter_initialize();
 
     // ustaw tryb uśpienia na tryb bezczynności
     set_sleep_mode(SLEEP_MODE_IDLE);
 
-    // odmaskuj przerwania
-    sei();
-
     while (1) {
+        frequency_meter_result_t result;
+        if (frequency_meter_update(&result)) {
+            print_result(&result);
+        }
+        // obudzi nas przerwanie miernika albo UART
         sleep_mode();
-
-        uint8_t period = last_period;
-        uint16_t frequency = TOP / period;
-        printf("Frequency: %u Hz\r\n", frequency);
-        uart_wait(); // poczekaj na UART zanim się uśpisz
-        _delay_us(400); // poczekaj jeszcze trochę
     }
 }
@@ -1,6 +1,6 @@
 #include "FreeRTOS.h"
+#include "adc_scan.h"
 #include "queue.h"
-#include "semphr.h"
 #include "task.h"
 #include <assert.h>
 #include <avr/interrupt.h>
@@ -70,58 +70,27 @@ FILE uart_file;
 #define THERMISTOR_MUX ADC1D
 #define PHOTORESISTOR_MUX ADC2D
 
-static void initialize_adc(void) {
-    ADMUX = _BV(REFS0); // referencja AVcc = 5V
-    // wyłącz wejścia cyfrowe na ADC0|1|2
-    DIDR0 = _BV(POTENTIOMETER_MUX) | _BV(THERMISTOR_MUX) | _BV(PHOTORESISTOR_MUX);
-    // częstotliwość zegara ADC 125 kHz (16 MHz / 128)
-    ADCSRA = _BV(ADPS0) | _BV(ADPS1) | _BV(ADPS2); // preskaler 128
-    ADCSRA |= _BV(ADEN); // włącz ADC
-}
-
-#define ENABLE_ADC_INTERRUPT ADCSRA |= _BV(ADIE);
-#define DISABLE_ADC_INTERRUPT ADCSRA &= ~_BV(ADIE);
-#define START_ADC_CONVERSION ADCSRA |= _BV(ADSC);
-
-SemaphoreHandle_t read_adc_mutex = NULL;
-StaticSemaphore_t read_adc_mutex_buffer;
-
-SemaphoreHandle_t adc_ready_semaphore = NULL;
-StaticSemaphore_t adc_ready_semaphore_buffer;
-
-ISR(ADC_vect) {
-    xSemaphoreGiveFromISR(adc_ready_semaphore, NULL);
-    DISABLE_ADC_INTERRUPT;
-}
-
-static uint16_t read_adc(uint8_t mux) {
-    mux &= 0x0F;
+// kolejność kanałów w skanie
+#define POTENTIOMETER_CHANNEL 0
+#define THERMISTOR_CHANNEL 1
+#define PHOTORESISTOR_CHANNEL 2
 
-    xSemaphoreTake(read_adc_mutex, portMAX_DELAY);
+static const uint8_t scanned_channels[] = { POTENTIOMETER_MUX, THERMISTOR_MUX, PHOTORESISTOR_MUX };
 
-    ADMUX |= mux;
-    ENABLE_ADC_INTERRUPT;
-    START_ADC_CONVERSION;
-
-    // Semafor jest na wejściu wzięty, więc tutaj poczekamy,
-    // aż zostanie oddany przez ADC interrupt handler.
-    xSemaphoreTake(adc_ready_semaphore, portMAX_DELAY);
-
-    uint16_t adc_result = ADC;
-    ADMUX &= ~mux;
-
-    xSemaphoreGive(read_adc_mutex);
-
-    return adc_result;
+// ADC skanuje wszystkie trzy kanały w trybie free running, a zadania tylko
+// odczytują ostatni wynik -- bez muteksu i czekania na konwersję.
+static void initialize_adc(void) {
+    adc_scan_initialize(scanned_channels, sizeof(scanned_channels), _BV(REFS0), ADC_SCAN_FREE_RUNNING);
+    adc_scan_start();
 }
 
-#define DEFINE_ADC_READ_TASK(name, mux, delay, format)           \
+#define DEFINE_ADC_READ_TASK(name, channel, delay, format)       \
     static void name##_task(void* parameters) {                  \
         (void)parameters;                                        \
         while (1) {                                              \
             TickType_t previous_wake_time = xTaskGetTickCount(); \
             vTaskDelayUntil(&previous_wake_time, delay);         \
-            uint16_t adc_result = read_adc(mux);                 \
+            uint16_t adc_result = adc_scan_latest(channel);      \
             printf(format "\r\n", adc_result);                   \
         }                                                        \
     }
@@ -131,7 +100,7 @@ static uint16_t read_adc(uint8_t mux) {
 #define POTENTIOMETER_TASK_STACK_SIZE configMINIMAL_STACK_SIZE + 200
 #define POTENTIOMETER_TASK_PRIORITY 1
 
-DEFINE_ADC_READ_TASK(potentiometer, POTENTIOMETER_MUX, POTENTIOMETER_DELAY,
+DEFINE_ADC_READ_TASK(potentiometer, POTENTIOMETER_CHANNEL, POTENTIOMETER_DELAY,
     "|          %4.u |               |               |")
 
 #define THERMISTOR_DELAY 913
@@ -139,7 +108,7 @@ DEFINE_ADC_READ_TASK(potentiometer, POTENTIOMETER_MUX, POTENTIOMETER_DELAY,
 #define THERMISTOR_TASK_STACK_SIZE configMINIMAL_STACK_SIZE + 200
 #define THERMISTOR_TASK_PRIORITY 1
 
-DEFINE_ADC_READ_TASK(thermistor, THERMISTOR_MUX, THERMISTOR_DELAY,
+DEFINE_ADC_READ_TASK(thermistor, THERMISTOR_CHANNEL, THERMISTOR_DELAY,
     "|               |          %4.u |               |")
 
 #define PHOTORESISTOR_DELAY 1421
@@ -147,7 +116,7 @@ DEFINE_ADC_READ_TASK(thermistor, THERMISTOR_MUX, THERMISTOR_DELAY,
 #define PHOTORESISTOR_TASK_STACK_SIZE configMINIMAL_STACK_SIZE + 200
 #define PHOTORESISTOR_TASK_PRIORITY 1
 
-DEFINE_ADC_READ_TASK(photoresistor, PHOTORESISTOR_MUX, PHOTORESISTOR_DELAY,
+DEFINE_ADC_READ_TASK(photoresistor, PHOTORESISTOR_CHANNEL, PHOTORESISTOR_DELAY,
     "|               |               |          %4.u |")
 
 #define LED_PORT PORTC
@@ -223,12 +192,6 @@ int main(void) {
 
     set_sleep_mode(SLEEP_MODE_IDLE);
 
-    read_adc_mutex = xSemaphoreCreateMutexStatic(&read_adc_mutex_buffer);
-    assert(read_adc_mutex != NULL);
-
-    adc_ready_semaphore = xSemaphoreCreateBinaryStatic(&adc_ready_semaphore_buffer);
-    assert(adc_ready_semaphore != NULL);
-
     CREATE_STATIC_TASK(potentiometer_task, potenti,
         POTENTIOMETER_TASK_STACK_SIZE, NULL, POTENTIOMETER_TASK_PRIORITY);
 
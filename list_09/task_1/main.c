@@ -1,11 +1,12 @@
 #include "hd44780.h"
+#include "ring_buffer.h"
+#include "timer_wheel.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <avr/sleep.h>
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
-#include <util/delay.h>
 
 #define ERROR_LED PB5
 #define ERROR_LED_DDR DDRB
@@ -16,48 +17,20 @@
 
 #define LCD_WIDTH 16
 
-#define BUFFER_SIZE LCD_WIDTH
-#define BUFFER_DATA uint8_t
-#define BUFFER_POINTER uint8_t
-
-#define BUFFER_INITIALIZE(name)                                 \
-    static void initialize_##name(BUFFER_DATA initial_value) {  \
-        name##_read_pointer = 0;                                \
-        name##_write_pointer = 0;                               \
-        for (uint8_t index = 0; index < BUFFER_SIZE; index++) { \
-            name##_buffer[index] = initial_value;               \
-        }                                                       \
-    }
+// znaki z przerwania UART do pętli głównej
+RING_BUFFER_CREATE(received, uint8_t, 16);
 
-#define BUFFER_READ(name)                               \
-    static BUFFER_DATA name##_read(void) {              \
-        BUFFER_POINTER read = name##_read_pointer;      \
-        name##_read_pointer = (read + 1) % BUFFER_SIZE; \
-        return name##_buffer[read];                     \
-    }
+// wpisywana linia, tak jak jest na wyświetlaczu, i pozycja kursora
+static char line[LCD_WIDTH];
+static uint8_t column;
 
-#define BUFFER_WRITE(name)                                \
-    static void name##_write(BUFFER_DATA data) {          \
-        BUFFER_POINTER write = name##_write_pointer;      \
-        name##_write_pointer = (write + 1) % BUFFER_SIZE; \
-        name##_buffer[write] = data;                      \
-    }
-
-#define BUFFER_IS_EMPTY(name)                               \
-    static bool is_##name##_empty(void) {                   \
-        return name##_read_pointer == name##_write_pointer; \
+static void initialize_line(char initial_value) {
+    received_clear();
+    column = 0;
+    for (uint8_t index = 0; index < LCD_WIDTH; index++) {
+        line[index] = initial_value;
     }
-
-#define BUFFER_CREATE(name)                                 \
-    static volatile BUFFER_DATA name##_buffer[BUFFER_SIZE]; \
-    static volatile BUFFER_POINTER name##_read_pointer;     \
-    static volatile BUFFER_POINTER name##_write_pointer;    \
-    BUFFER_INITIALIZE(name);                                \
-    BUFFER_READ(name);                                      \
-    BUFFER_WRITE(name);                                     \
-    BUFFER_IS_EMPTY(name);
-
-BUFFER_CREATE(line);
+}
 
 static void initialize_uart(void) {
     // ustaw baudrate
@@ -92,7 +65,7 @@ ISR(USART_RX_vect) {
         break;
     }
     default: {
-        line_write(input);
+        received_write(input);
         set_bit(NEW_CHARACTER_RECEIVED);
         break;
     }
@@ -100,14 +73,14 @@ ISR(USART_RX_vect) {
 }
 
 static int uart_receive(FILE* stream) {
-    if (is_line_empty()) {
+    uint8_t result;
+    if (!received_read(&result)) {
         // Ta sytuacja nigdy nie powinna się wydarzyć chyba, że napisaliśmy źle program.
         // Przed wywołaniem powinniśmy sprawdzić czy NEW_CHARACTER_RECEIVED jest ustawione.
         ERROR_LED_PORT |= _BV(ERROR_LED);
         return 0;
     }
 
-    BUFFER_DATA result = line_read();
     return result;
 }
 
@@ -121,13 +94,16 @@ static FILE io_file;
 #define TICK_RATE 1000
 #define TICK_PERIOD 1
 
+static uint16_t tick_counter = 0;
+static timer_wheel_timer_t tick_timer;
+
 // static inline void set_cursor() {
-//     LCD_GoTo(line_write_pointer, 1);
+//     LCD_GoTo(column, 1);
 //     putchar('_');
 // }
 
 // static inline void clear_cursor() {
-//     LCD_GoTo(line_write_pointer, 1);
+//     LCD_GoTo(column, 1);
 //     putchar(' ');
 // }
 
@@ -140,17 +116,18 @@ static FILE io_file;
 // }
 
 static inline void print_buffer(void) {
-    for (uint8_t index = 0; index < BUFFER_SIZE; index++) {
-        char character = line_buffer[index];
-        putchar(character);
+    for (uint8_t index = 0; index < LCD_WIDTH; index++) {
+        putchar(line[index]);
     }
 }
 
 static inline void dump_buffer_with_echo(void) {
-    while (!is_line_empty()) {
-        LCD_GoTo(line_read_pointer, 1);
+    while (!received_is_empty()) {
+        LCD_GoTo(column, 1);
         char character = getchar();
         putchar(character);
+        line[column] = character;
+        column = (column + 1) % LCD_WIDTH;
     }
 }
 
@@ -160,6 +137,16 @@ static inline void clear_line() {
     }
 }
 
+// takt co TICK_PERIOD ms z timer_wheel, wołany w pętli głównej
+static void on_tick(void* context) {
+    // blink_cursor(tick_counter);
+
+    tick_counter++;
+    if (tick_counter == TICK_RATE + 1) {
+        tick_counter = 0;
+    }
+}
+
 static inline void enable_cursor(void) {
     LCD_WriteCommand(HD44780_DISPLAY_ONOFF | HD44780_DISPLAY_ON | HD44780_CURSOR_ON | HD44780_CURSOR_BLINK);
 }
@@ -183,14 +170,15 @@ int main(void) {
     LCD_GoTo(0, 1);
     enable_cursor();
 
-    uint16_t tick_counter = 0;
+    timer_wheel_initialize();
+    timer_wheel_start(&tick_timer, TIMER_WHEEL_MS(TICK_PERIOD), TIMER_WHEEL_MS(TICK_PERIOD), on_tick, NULL);
     while (1) {
         cli();
         if (is_bit_set(NEW_CHARACTER_RECEIVED)) {
             disable_cursor();
             dump_buffer_with_echo();
 
-            LCD_GoTo(line_read_pointer, 1);
+            LCD_GoTo(column, 1);
             enable_cursor();
 
             clear_bit(NEW_CHARACTER_RECEIVED);
@@ -213,12 +201,9 @@ int main(void) {
         }
         sei();
 
-        // blink_cursor(tick_counter);
-
-        _delay_ms(TICK_PERIOD);
-        tick_counter++;
-        if (tick_counter == TICK_RATE + 1) {
-            tick_counter = 0;
+        // zamiast _delay_ms: śpij do następnego znaku z UART albo taktu
+        if (!timer_wheel_dispatch()) {
+            timer_wheel_sleep();
         }
     }
 }
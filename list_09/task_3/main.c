@@ -1,5 +1,9 @@
+#include "fixed_format.h"
+#include "lm35.h"
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <util/delay.h>
 
@@ -7,40 +11,6 @@
 #define MOSFET_DDR DDRB
 #define MOSFET_PORT PORTB
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-static inline void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-    // receive complete interrupt enable
-    UCSR0B |= _BV(RXCIE0);
-}
-
-// transmisja jednego znaku
-static int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-static int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
-FILE uart_file;
-
 // #define ACTIVE_THERMISTOR_MUX ADC0D
 #define ACTIVE_THERMISTOR_MUX ADC3D
 
@@ -62,26 +32,19 @@ static inline uint16_t read_adc(void) {
     return ADC; // weź zmierzoną wartość (0..1023)
 }
 
-static inline float read_voltage(void) {
-    uint16_t adc = read_adc();
-    const float vref = 1.1;
-    return (adc * vref * 1000.0) / 1024.0;
-}
-
-static inline float voltage_to_temperature(float voltage) {
-    const float temperature_coefficient = 10.0;
-    const float zero_degree_volatage = 500.0;
-    return (voltage - zero_degree_volatage) / temperature_coefficient;
+static inline uint16_t read_milivolts(void) {
+    return adc_to_milivolts(read_adc());
 }
 
-static volatile uint8_t sampling_enabled = 1;
-
-// Receive Complete Interrupt
-ISR(USART_RX_vect) {
-    const uint8_t input = UDR0;
-    if (input == 's') {
-        sampling_enabled = 0;
+// 's' z UART przerywa pomiary i wraca do pytania o temperaturę
+static bool stop_requested(void) {
+    uint8_t input;
+    while (uart_try_read(&input)) {
+        if (input == 's') {
+            return true;
+        }
     }
+    return false;
 }
 
 #define ENABLE_MOSFET MOSFET_PORT |= _BV(MOSFET);
@@ -92,29 +55,27 @@ int main(void) {
     DISABLE_MOSFET;
 
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
 
     initialize_adc();
     sei();
 
-    const uint8_t temperature_delta = 1;
-    float goal_temperature = 0;
+    const int16_t temperature_delta = 10; // 1°C
+    int16_t goal_temperature = 0;
     while (1) {
-        UCSR0B &= ~_BV(RXCIE0);
-        printf("\r\nPodaj temperaturę...\r\n");
-        scanf("%f", &goal_temperature);
-        sampling_enabled = 1;
-        UCSR0B |= _BV(RXCIE0);
+        printf("\r\nPodaj temperaturę [d°C]...\r\n");
+        scanf("%" SCNi16, &goal_temperature);
 
         ENABLE_MOSFET;
-        while (sampling_enabled) {
-            float voltage = read_voltage();
-            float temperature = voltage_to_temperature(voltage);
+        while (!stop_requested()) {
+            const uint16_t voltage = read_milivolts();
+            const int16_t temperature = milivolts_to_decycelsius(voltage);
 
-            printf("Temperatura: %f°C (%f mV)\r\n", temperature, voltage);
+            char temperature_text[8];
+            format_decycelsius(temperature_text, sizeof(temperature_text), temperature);
+            printf("Temperatura: %s°C (%" PRIu16 " mV)\r\n", temperature_text, voltage);
 
             if (temperature >= goal_temperature) {
                 DISABLE_MOSFET;
@@ -1,3 +1,4 @@
+#include "motor.h"
 #include <avr/io.h>
 #include <util/delay.h>
 
@@ -36,8 +37,6 @@ static int uart_receive(FILE* stream) {
 FILE uart_file;
 
 #define EN PB0
-#define TIMER_1A PB1
-#define TIMER_1B PB2
 #define POTENTIOMETER_MUX ADC0D
 
 static inline void initialize_adc(void) {
@@ -59,23 +58,12 @@ static inline uint16_t read_adc(void) {
 }
 
 #define ADC_MAXIMUM 1023
-#define TIMER_ADC_MULTIPLIER 2
+// pełna prędkość w jedną stronę w 0.5 s
+#define ACCELERATION (2 * MOTOR_MAX)
 
-static inline void initialize_timer(void) {
-    // ustaw tryb licznika
-    // COM1A = 10   -- non-inverting mode
-    // COM1B = 10   -- non-inverting mode
-    // WGM1  = 1110 -- fast PWM top=ICR1
-    // CS1   = 010  -- prescaler 8
-    // ICR1  = 2046
-    // częstotliwość 16e6/(8*(1+2046)) = 977 Hz
-    // wzór: datasheet 20.12.3 str. 164
-
-    ICR1 = ADC_MAXIMUM * TIMER_ADC_MULTIPLIER;
-    TCCR1A = _BV(WGM11);
-    TCCR1B = _BV(WGM12) | _BV(WGM13) | _BV(CS11);
-    // ustaw pin OC1A i OC1B (PB1, PB2) jako wyjście
-    DDRB |= _BV(TIMER_1A) | _BV(TIMER_1B);
+// potencjometr w połowie to postój, na końcach pełna prędkość w obie strony
+static inline int16_t adc_to_speed(uint16_t adc) {
+    return ((int32_t)(ADC_MAXIMUM / 2) - adc) * MOTOR_MAX / (ADC_MAXIMUM / 2);
 }
 
 int main(void) {
@@ -86,25 +74,15 @@ int main(void) {
     // stdin = stdout = stderr = &uart_file;
 
     initialize_adc();
-    initialize_timer();
+    motor_initialize();
+    motor_set_acceleration(ACCELERATION);
     DDRB |= _BV(EN);
     PORTB |= _BV(EN);
 
     while (1) {
         uint16_t adc = read_adc();
-        if (adc <= ADC_MAXIMUM / 2) {
-            TCCR1A |= _BV(COM1A1);
-            TCCR1A &= ~_BV(COM1B1);
-            PORTB &= ~_BV(TIMER_1B);
-            OCR1A = (ADC_MAXIMUM - adc * 2) * TIMER_ADC_MULTIPLIER;
-            // printf("%u %u\r\n", adc, OCR1A);
-        } else {
-            TCCR1A &= ~_BV(COM1A1);
-            TCCR1A |= _BV(COM1B1);
-            PORTB &= ~_BV(TIMER_1A);
-            OCR1B = (ADC_MAXIMUM - (ADC_MAXIMUM - adc) * 2) * TIMER_ADC_MULTIPLIER;
-            // printf("%u %u\r\n", adc, OCR1B);
-        }
-        _delay_ms(100);
+        motor_set_speed(adc_to_speed(adc));
+        // printf("%u %d\r\n", adc, motor_speed());
+        _delay_ms(1);
     }
 }
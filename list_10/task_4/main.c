@@ -1,3 +1,4 @@
+#include "servo.h"
 #include <avr/io.h>
 #include <util/delay.h>
 
@@ -57,20 +58,15 @@ static inline uint16_t read_adc(void) {
 
 #define ADC_MAXIMUM 1023
 
-static inline void initialize_timer(void) {
-    // ustaw tryb licznika
-    // COM1A = 10   -- non-inverting mode
-    // WGM1  = 1110 -- fast PWM top=ICR1
-    // CS1   = 010  -- prescaler 8
-    // ICR1  = 1249
-    // częstotliwość 16e6/(8*(1+39999)) = 50 Hz
-    // wzór: datasheet 20.12.3 str. 164
+// Serwo na PB1 (kanał 0 common/servo), drugie na PB2 (kanał 1) kręci się
+// w przeciwną stronę z ograniczoną prędkością. Pozostałe kanały są wolne.
+#define SERVO_MAIN 0
+#define SERVO_MIRROR 1
+#define SERVO_MIRROR_SPEED 500 // µs na sekundę
 
-    ICR1 = 39999;
-    TCCR1A = _BV(COM1A1) | _BV(WGM11);
-    TCCR1B = _BV(WGM12) | _BV(WGM13) | _BV(CS11);
-    // ustaw pin OC1A (PB1) jako wyjście
-    DDRB |= _BV(PB1);
+// ten sam zakres co dawniej OCR1A = 116 * adc / 33 + 1029 przy 0.5 µs
+static inline uint16_t adc_to_microseconds(uint32_t adc) {
+    return 58 * adc / 33 + 515;
 }
 
 int main(void) {
@@ -81,12 +77,16 @@ int main(void) {
     // stdin = stdout = stderr = &uart_file;
 
     initialize_adc();
-    initialize_timer();
+    servo_initialize();
+    servo_set_speed(SERVO_MIRROR, SERVO_MIRROR_SPEED);
 
     while (1) {
         uint32_t adc = read_adc();
-        OCR1A = 116 * adc / 33 + 1029;
-        // printf("%u %u\r\n", adc, OCR1A);
+        const uint16_t microseconds = adc_to_microseconds(adc);
+        servo_write(SERVO_MAIN, microseconds);
+        servo_write(SERVO_MIRROR, adc_to_microseconds(ADC_MAXIMUM - adc));
+        servo_update();
+        // printf("%u %u\r\n", adc, microseconds);
         _delay_ms(10);
     }
 }
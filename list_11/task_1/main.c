@@ -1,42 +1,26 @@
+#include "fixed_format.h"
+#include "lm35.h"
 #include "pid.h"
+#include "relay_tune.h"
+#include "telemetry.h"
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <stdio.h>
+#include <util/atomic.h>
 #include <util/delay.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-static inline void uart_init() {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-    // receive complete interrupt enable
-    UCSR0B |= _BV(RXCIE0);
-}
-
-// transmisja jednego znaku
-static int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-static int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
+// Zamiast tekstu wysyłaj binarne rekordy pid_sample (tools/telemetry)
+#define BINARY_TELEMETRY
+#undef BINARY_TELEMETRY
 
-FILE uart_file;
+#ifdef BINARY_TELEMETRY
+// ramka pid_sample to 12 bajtów, przy 9600 bodów ok. 12.5 ms; co 20 ms
+// zajmuje ok. 60% łącza i obejmuje prawie każdą próbkę regulatora (61 Hz)
+#define REPORT_PERIOD_MS 20
+#else
+#define REPORT_PERIOD_MS 100
+#endif
 
 #define ACTIVE_THERMISTOR_MUX ADC0D
 
@@ -48,7 +32,7 @@ static inline void initialize_adc(void) {
     DIDR0 = _BV(ACTIVE_THERMISTOR_MUX);
     // częstotliwość zegara ADC 125 kHz (16 MHz / 128)
     ADCSRA = _BV(ADPS0) | _BV(ADPS1) | _BV(ADPS2); // preskaler 128
-    ADCSRA |= _BV(ADIE) | _BV(ADATE); // enable interrupt and auto-trigger
+    ADCSRA |= _BV(ADATE); // auto-trigger; przerwanie włączamy dopiero na czas regulacji
     ADCSRB |= _BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0); // auto-trigger on timer 1 input capture
     // ADCSRA |= _BV(ADSC); // wykonaj konwersję
     ADCSRA |= _BV(ADEN); // włącz ADC
@@ -61,25 +45,6 @@ static inline uint16_t read_adc(void) {
     return ADC; // weź zmierzoną wartość (0..1023)
 }
 
-static inline uint16_t adc_to_milivolts(uint32_t adc) {
-    const uint32_t vref_times_1000 = 1100;
-    return (adc * vref_times_1000) / 1024;
-}
-
-static inline int16_t milivolts_to_decycelsius(uint16_t milivolts) {
-    // const int32_t temperature_coefficient = 10;
-    const int32_t zero_degree_volatage = 500;
-    return (milivolts - zero_degree_volatage) /* * (10 / temperature_coefficient) */;
-}
-
-static inline uint16_t decycelsius_to_milivolts(int16_t decycelsius) {
-    return decycelsius + 500;
-}
-
-static inline uint16_t milivolts_to_adc(uint32_t milivolts) {
-    return (1024 * milivolts) / 1100;
-}
-
 static inline int16_t clamp(int16_t lower, int16_t upper, int16_t value) {
     if (value < lower) {
         return lower;
@@ -94,15 +59,21 @@ static inline int16_t clamp(int16_t lower, int16_t upper, int16_t value) {
 #define clear_bit(reg, index) (reg) &= ~_BV(index);
 #define get_bit(reg, index) ((reg)&_BV(index))
 
-static volatile uint8_t flags;
+static uint8_t flags;
 #define PID_TIMER_FLAG 0
 #define SAMPLING_ENABLED_FLAG 1
 
-// Receive Complete Interrupt
-ISR(USART_RX_vect) {
-    const uint8_t input = UDR0;
-    if (input == 's') {
-        clear_bit(flags, SAMPLING_ENABLED_FLAG);
+static void start_tuning(void);
+
+// s -- koniec regulacji, t -- automatyczny dobór nastaw przy bieżącej temperaturze zadanej
+static inline void check_keys(void) {
+    uint8_t input;
+    while (uart_try_read(&input)) {
+        if (input == 's') {
+            clear_bit(flags, SAMPLING_ENABLED_FLAG);
+        } else if (input == 't') {
+            start_tuning();
+        }
     }
 }
 
@@ -142,15 +113,17 @@ static inline void disable_mosfet(void) {
 //     OCR1A = 0;
 // }
 
+#define PWM_TOP 128
+
 static inline void initialize_timer(void) {
     // ustaw tryb licznika
     // COM1A = 10   -- non-inverting mode
     // WGM1  = 1000 -- Phase and Frequency Correct PWM top=ICR1
     // CS1   = 101  -- prescaler 1024
-    // ICR1  = 256
-    // częstotliwość 16e6/(2*1024*256) = 30.5 Hz
+    // ICR1  = 128
+    // częstotliwość 16e6/(2*1024*128) = 61 Hz
 
-    ICR1 = SCALING_FACTOR;
+    ICR1 = PWM_TOP;
     TCCR1A = _BV(COM1A1);
     TCCR1B = _BV(WGM13) | _BV(CS12) | _BV(CS10);
     TIMSK1 = _BV(ICIE1) /* | _BV(TOIE1) */;
@@ -159,31 +132,47 @@ static inline void initialize_timer(void) {
     OCR1A = 0;
 }
 
-static struct PID_DATA pidData;
+static pid_controller_t pid;
+static relay_tune_t tune;
+static volatile bool tuning = false;
 static volatile int16_t goal = 0;
 static volatile int16_t last_pid_input = 0;
 static volatile uint16_t last_adc = 0;
+static int16_t mosfet_accumulator = 0;
+
+// Wyjście -PWM_TOP..PWM_TOP to wypełnienie 0..100%: modulacja sigma-delta
+// z okresem próbkowania (grzałka i tak uśrednia). Dzięki temu przekaźnik
+// z relay_tune (pełna moc / brak mocy) i PID mają tę samą skalę.
+static inline void drive_mosfet(int16_t output) {
+    mosfet_accumulator += output + PWM_TOP;
+    if (mosfet_accumulator >= 2 * PWM_TOP) {
+        mosfet_accumulator -= 2 * PWM_TOP;
+        enable_mosfet();
+    } else {
+        disable_mosfet();
+    }
+}
 
 // ISR(TIMER1_OVF_vect) {
 //     const uint16_t shift = 0;
-//     OCR1A = clamp(-SCALING_FACTOR / 2 + shift, SCALING_FACTOR / 2 + shift, last_pid_input) + SCALING_FACTOR / 2 - shift;
+//     OCR1A = clamp(-PWM_TOP / 2 + shift, PWM_TOP / 2 + shift, last_pid_input) + PWM_TOP / 2 - shift;
 // }
 
 ISR(TIMER1_CAPT_vect) { }
 
 ISR(ADC_vect) {
     last_adc = ADC;
-    last_pid_input = pid_Controller(goal, last_adc, &pidData);
-    if (last_pid_input > 0) {
-        enable_mosfet();
+    if (tuning) {
+        last_pid_input = relay_tune_update(&tune, last_adc);
     } else {
-        disable_mosfet();
+        last_pid_input = pid_update(&pid, goal, last_adc);
     }
+    drive_mosfet(last_pid_input);
 }
 
 // ISR(TIMER0_OVF_vect) {
 //     const uint16_t adc = read_adc();
-//     const int16_t input_value = pid_Controller(goal, adc, &pidData);
+//     const int16_t input_value = pid_update(&pid, goal, adc);
 //     if (input_value > 0) {
 //         enable_mosfet();
 //     } else {
@@ -191,17 +180,81 @@ ISR(ADC_vect) {
 //     }
 // }
 
-/*! \brief P, I and D parameter values
- *
- * The K_P, K_I and K_D values (P, I and D gains)
- * need to be modified to adapt to the application at hand
- */
+// Wzmocnienia na próbkę (ADC co okres Timer1, 61 Hz). Q16.16 zachowuje
+// małe Ki i Kd, które przy dawnym SCALING_FACTOR 128 obcinały się do zera.
 #define K_P 0.65 * 6.00
 #define K_I 0.5 * 0.10
 #define K_D 0.12 * 0.10
 
+static const pid_parameters_t pid_parameters = {
+    .kp = PID_GAIN(K_P),
+    .ki = PID_GAIN(K_I),
+    .kd = PID_GAIN(K_D),
+    .kt = PID_GAIN(K_I / (K_P)),
+    .setpoint_weight_p = PID_ONE,
+    .setpoint_weight_d = 0,
+    .derivative_filter_shift = 2,
+    .output_min = -PWM_TOP,
+    .output_max = PWM_TOP,
+};
+
 static inline void initialize_pid(void) {
-    pid_Init(K_P * SCALING_FACTOR, K_I * SCALING_FACTOR, K_D * SCALING_FACTOR, &pidData);
+    pid_initialize(&pid, &pid_parameters);
+}
+
+// Przekaźnik ±3 kody ADC (±0.3°C) wokół temperatury zadanej; przy okresie
+// drgań grzałki rzędu minuty pomiar trwa kilka minut.
+#define TUNE_HYSTERESIS 3
+#define TUNE_TIMEOUT_S 3600UL
+#define SAMPLE_RATE (F_CPU / (2UL * 1024 * PWM_TOP))
+
+static void start_tuning(void) {
+    if (tuning) {
+        return;
+    }
+    relay_tune_start(&tune, goal, TUNE_HYSTERESIS, PWM_TOP, -PWM_TOP, TUNE_TIMEOUT_S * SAMPLE_RATE);
+    tuning = true;
+#ifndef BINARY_TELEMETRY
+    printf("\r\nAutotune...\r\n");
+#endif
+}
+
+// w trybie binarnym tekst rozbiłby ramki, więc wynik widać tylko po
+// zmianie zachowania regulatora w rekordach pid_sample
+#ifndef BINARY_TELEMETRY
+static void print_gain(const char* name, pid_gain_t gain) {
+    char text[16];
+    format_q(text, sizeof(text), gain, PID_GAIN_FRACTION_BITS, 4);
+    printf("%s = %s\r\n", name, text);
+}
+#endif
+
+// po zakończeniu pomiaru: policz nastawy poza przerwaniem i podmień je
+static void finish_tuning(void) {
+    if (!tuning || tune.status == RELAY_TUNE_RUNNING) {
+        return;
+    }
+    pid_parameters_t parameters = pid.parameters;
+    const bool success = relay_tune_gains(&tune, RELAY_TUNE_CLASSIC, &parameters);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (success) {
+            pid_initialize(&pid, &parameters);
+        } else {
+            pid_reset(&pid);
+        }
+        tuning = false;
+    }
+#ifndef BINARY_TELEMETRY
+    uart_flush();
+    if (!success) {
+        printf("\r\nAutotune failed\r\n");
+        return;
+    }
+    printf("\r\nTu = %" PRIu16 " samples, a = %" PRIu16 "\r\n", tune.period, tune.amplitude);
+    print_gain("Kp", parameters.kp);
+    print_gain("Ki", parameters.ki);
+    print_gain("Kd", parameters.kd);
+#endif
 }
 
 int main(void) {
@@ -210,18 +263,19 @@ int main(void) {
     disable_mosfet();
 
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
 
     initialize_pid();
     initialize_timer();
     initialize_adc();
+    sei();
 
     while (1) {
-        UCSR0B &= ~_BV(RXCIE0);
+#ifndef BINARY_TELEMETRY
         printf("\r\nPodaj temperaturę [d°C]...\r\n");
+#endif
 
         int16_t goal_temperature;
         scanf("%" SCNi16, &goal_temperature);
@@ -230,50 +284,43 @@ int main(void) {
         goal = goal_adc;
 
         set_bit(flags, SAMPLING_ENABLED_FLAG);
-        UCSR0B |= _BV(RXCIE0);
 
+        pid_reset(&pid);
         enable_mosfet();
-        sei();
+        ADCSRA |= _BV(ADIE);
         while (get_bit(flags, SAMPLING_ENABLED_FLAG)) {
+            cli();
             const uint16_t adc = last_adc;
+            const int16_t pid_input = last_pid_input;
+            sei();
+#ifdef BINARY_TELEMETRY
+            const telemetry_pid_sample_t sample = { goal, adc, pid_input };
+            TELEMETRY_SEND(pid_sample, &sample);
+#else
             const uint16_t volatage = adc_to_milivolts(adc);
             const int16_t temperature = milivolts_to_decycelsius(volatage);
 
-            printf(
+            // Linia trafia do bufora nadawczego bez czekania na UART. Jeśli
+            // poprzednia jeszcze się nie wysłała, to pomijamy tę próbkę zamiast
+            // blokować pętlę.
+            char line[80];
+            const int length = snprintf(
+                line, sizeof(line),
                 "Temperature: %" PRIi16 " [d°C] (%" PRIu16 " [mV], %" PRIu16 ") PID: %" PRId16 "\r\n",
-                temperature, volatage, adc, last_pid_input);
-
-            _delay_ms(100);
+                temperature, volatage, adc, pid_input);
+            if (length > 0 && length < (int)sizeof(line) && uart_bytes_free() >= length) {
+                uart_write((const uint8_t*)line, length);
+            }
+#endif
+
+            check_keys();
+            finish_tuning();
+            _delay_ms(REPORT_PERIOD_MS);
         }
-        cli();
+        ADCSRA &= ~_BV(ADIE);
+        tuning = false;
         OCR1A = 0;
         disable_mosfet();
+        uart_flush();
     }
 }
-
-/*! \mainpage
- * \section Intro Introduction
- * This documents data structures, functions, variables, defines, enums, and
- * typedefs in the software for application note AVR221.
- *
- * \section CI Compilation Info
- * This software was written for the IAR Embedded Workbench 4.11A.
- *
- * To make project:
- * <ol>
- * <li> Add the file main.c and pid.c to project.
- * <li> Under processor configuration, select desired Atmel AVR device.
- * <li> Enable bit definitions in I/O include files
- * <li> High optimization on speed is recommended for best performance
- * </ol>
- *
- * \section DI Device Info
- * The included source code is written for all Atmel AVR devices.
- *
- * \section TDL ToDo List
- * \todo Put in own code in:
- * \ref Get_Reference(void), \ref Get_Measurement(void) and \ref Set_Input(int16_t inputValue)
- *
- * \todo Modify the \ref K_P (P), \ref K_I (I) and \ref K_D (D) gain to adapt to your application
- * \todo Specify the sampling interval time \ref TIME_INTERVAL
- */
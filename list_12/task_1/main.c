@@ -1,40 +1,12 @@
+#include "fixed_format.h"
+#include "thermistor.h"
+#include "thermistor_table.h"
+#include "uart.h"
+#include <avr/interrupt.h>
 #include <avr/io.h>
-#include <math.h>
 #include <stdio.h>
 #include <util/delay.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-static inline void uart_init(void) {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-static int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-static int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
-FILE uart_file;
-
 #define THERMISTOR_MUX ADC0D
 
 // inicjalizacja ADC
@@ -70,30 +42,30 @@ static inline uint16_t read_adc(void) {
 
 int main() {
     // zainicjalizuj UART
-    uart_init();
+    uart_initialize();
     // skonfiguruj strumienie wejścia/wyjścia
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_setup_stdio();
+    // nadawanie i odbiór działają na przerwaniach
+    sei();
 
     initialize_adc();
 
     while (1) {
         uint16_t adc = read_adc();
         printf("%" PRIu16 "\r\n", adc);
-        const float vref = 1.1;
-        float thermistor_voltage = (adc * vref) / 1024;
-        printf("%f\r\n", thermistor_voltage);
+        // vref = 1.1V
+        const uint32_t thermistor_microvolts = (adc * 1100000UL) / 1024;
+        char text[12];
+        format_milivolts(text, sizeof(text), thermistor_microvolts / 1000, 3);
+        printf("%s V\r\n", text);
         // R = U/I
         // 1/(10^(-6) * 130)
-        float thermistor_resistance = thermistor_voltage * 7692.307;
-        printf("%f\r\n", thermistor_resistance);
-        const float T_0 = 298.15;
-        const float R_0 = 4700;
-        // const float thermistor_constant = 3206.637682344697;
-        const float thermistor_constant = 5650.711391225834;
-        float temperature = thermistor_constant / (log(thermistor_resistance / R_0) + (thermistor_constant / T_0));
-        float temperature_celsius = temperature - 273.15;
-        printf("Odczytano: %f°C\r\n", temperature_celsius);
+        const uint32_t thermistor_resistance = thermistor_microvolts / 130;
+        printf("%" PRIu32 " Ohm\r\n", thermistor_resistance);
+        // temperatura z tablicy wygenerowanej dla I = 130 uA, R_0 = 4700,
+        // T_0 = 298.15 K, B = 5650.71 (tools/thermistor)
+        format_decycelsius(text, sizeof(text), thermistor_decycelsius(thermistor_table, adc));
+        printf("Odczytano: %s°C\r\n", text);
         _delay_ms(1000);
     }
 }
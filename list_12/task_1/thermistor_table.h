@@ -0,0 +1,53 @@
+#ifndef __THERMISTOR_TABLE_H
+#define __THERMISTOR_TABLE_H
+
+// Wygenerowane przez tools/thermistor:
+//     current 1.1 0.00013 4700 298.15 5650.711391225834 2
+// Maksymalny błąd interpolacji w zakresie 0..1000 d°C: 2.66 d°C.
+
+#include "thermistor.h"
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+#if THERMISTOR_TABLE_SHIFT != 2
+#error "table generated for -DTHERMISTOR_TABLE_SHIFT=2"
+#endif
+
+// temperatura [d°C] dla ADC = 0, 4, ..., 1024
+static const int16_t thermistor_table[THERMISTOR_TABLE_SIZE] PROGMEM = {
+    1500, 1306, 1116, 1012, 942, 890, 848, 813,
+    784, 758, 736, 715, 697, 681, 665, 651,
+    638, 626, 615, 604, 594, 585, 576, 567,
+    559, 551, 544, 536, 530, 523, 517, 511,
+    505, 499, 493, 488, 483, 478, 473, 468,
+    464, 459, 455, 451, 447, 443, 439, 435,
+    431, 428, 424, 421, 417, 414, 411, 407,
+    404, 401, 398, 395, 392, 389, 387, 384,
+    381, 378, 376, 373, 371, 368, 366, 363,
+    361, 359, 356, 354, 352, 350, 348, 345,
+    343, 341, 339, 337, 335, 333, 331, 329,
+    327, 326, 324, 322, 320, 318, 317, 315,
+    313, 311, 310, 308, 306, 305, 303, 302,
+    300, 298, 297, 295, 294, 292, 291, 289,
+    288, 287, 285, 284, 282, 281, 280, 278,
+    277, 276, 274, 273, 272, 270, 269, 268,
+    267, 265, 264, 263, 262, 261, 259, 258,
+    257, 256, 255, 254, 252, 251, 250, 249,
+    248, 247, 246, 245, 244, 243, 242, 241,
+    240, 239, 238, 236, 235, 235, 234, 233,
+    232, 231, 230, 229, 228, 227, 226, 225,
+    224, 223, 222, 221, 220, 219, 219, 218,
+    217, 216, 215, 214, 213, 213, 212, 211,
+    210, 209, 208, 208, 207, 206, 205, 204,
+    203, 203, 202, 201, 200, 200, 199, 198,
+    197, 197, 196, 195, 194, 194, 193, 192,
+    191, 191, 190, 189, 188, 188, 187, 186,
+    186, 185, 184, 184, 183, 182, 182, 181,
+    180, 180, 179, 178, 178, 177, 176, 176,
+    175, 174, 174, 173, 172, 172, 171, 170,
+    170, 169, 169, 168, 167, 167, 166, 166,
+    165, 164, 164, 163, 163, 162, 161, 161,
+    160,
+};
+
+#endif
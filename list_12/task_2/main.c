@@ -1,41 +1,12 @@
+#include "fixed_format.h"
+#include "fixed_math.h"
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
-#include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include <util/delay.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-static inline void uart_init(void) {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-static int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-static int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
-FILE uart_file;
-
 #define MICROPHONE_MUX ADC1D
 
 static inline void initialize_adc(void) {
@@ -97,9 +68,8 @@ static inline void initialize_timer(void) {
 ISR(TIMER1_OVF_vect) { }
 
 int main() {
-    uart_init();
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_initialize();
+    uart_setup_stdio();
 
     initialize_adc();
     initialize_timer();
@@ -115,11 +85,29 @@ int main() {
             samples_squares_sum = 0;
             sei();
 
-            const float mean = sqrt((float)squares_sum / counter);
-            const float mean_volts = (mean * 5.0) / 1024.0;
-            const float x_ref = ((OFFSET - 50) * 5.0) / 1024.0;
-            const float decibels = 20.0 * log10(mean_volts / x_ref);
-            printf("Sum: %lu (%u); Mean: %f mV (%f); %f dBFS\r\n", squares_sum, counter, mean_volts, mean, decibels);
+            // średni kwadrat w Q8 (bez dzielenia 64-bitowego)
+            const uint32_t mean_square = squares_sum / counter;
+            const uint32_t mean_square_remainder = squares_sum % counter;
+            const uint32_t mean_square_q8 = (mean_square << 8) + (mean_square_remainder << 8) / counter;
+            // pierwiastek z Q8 daje Q4
+            const uint16_t mean_q4 = fixed_sqrt32(mean_square_q8);
+            // 5 V / 1024 / 16 = 305.17578125 uV = 78125 / 256 uV
+            const int32_t mean_microvolts = ((uint32_t)mean_q4 * 78125) / 256;
+            const int16_t centidecibels = fixed_centidecibels(mean_q4, (uint32_t)(OFFSET - 50) << 4);
+
+            char mean_volts_text[12];
+            char mean_text[12];
+            char decibels_text[12];
+            format_fixed(mean_volts_text, sizeof(mean_volts_text), mean_microvolts, 6, 3);
+            format_q(mean_text, sizeof(mean_text), mean_q4, 4, 2);
+            if (centidecibels == FIXED_CENTIDECIBELS_MIN) {
+                // cisza w oknie - średnia 0
+                strcpy(decibels_text, "-inf");
+            } else {
+                format_centidecibels(decibels_text, sizeof(decibels_text), centidecibels);
+            }
+            printf("Sum: %lu (%u); Mean: %s V (%s); %s dBFS\r\n", squares_sum, counter, mean_volts_text, mean_text,
+                   decibels_text);
         }
 
         _delay_ms(100);
@@ -1,97 +1,118 @@
+#include "fixed_format.h"
+#include "frequency_meter.h"
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <avr/sleep.h>
+#include <inttypes.h>
 #include <stdio.h>
-#include <util/delay.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-static inline void uart_init(void) {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-static int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-static int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
-FILE uart_file;
-
-#define PHOTORESISTOR_PORT PORTD
-#define PHOTORESISTOR_PIN PIND
-#define PHOTORESISTOR PD2
+// Fotorezystor (z pull-upem) podłączony do wejść miernika: ICP1 (PB0)
+// i T1 (PD5). Zamiast zliczania przerwań INT0 przez sekundę używamy
+// common/frequency_meter, który przy niskich częstotliwościach mierzy okres
+// co do cyklu, a przy wysokich przełącza się na zliczanie sprzętowe.
+#define PHOTORESISTOR_PORT PORTB
+#define PHOTORESISTOR PB0
+#define PHOTORESISTOR_COUNTER_PORT PORTD
+#define PHOTORESISTOR_COUNTER PD5
+
+// Dioda na OC2A (PB3): Timer2 w trybie CTC przełącza ją sprzętowo, więc
+// częstotliwość jest dokładna co do cyklu preskalera (Timer1 jest zajęty
+// przez miernik).
+#define LED_DDR DDRB
+#define LED PB3
 
 static void initialize_io() {
-    // ustaw pull-up na PD2 (INT0)
+    // ustaw pull-up na PB0 (ICP1) i PD5 (T1)
     PHOTORESISTOR_PORT |= _BV(PHOTORESISTOR);
-    // ustaw wyzwalanie przerwania na INT0 zboczem narastającym
-    EICRA |= _BV(ISC00) | _BV(ISC01);
-    // odmaskuj przerwania dla INT0
-    EIMSK |= _BV(INT0);
+    PHOTORESISTOR_COUNTER_PORT |= _BV(PHOTORESISTOR_COUNTER);
+    LED_DDR |= _BV(LED);
 }
 
-static volatile uint16_t counter = 0;
+// preskalery Timer2 dla CS2 = 001..111
+static const uint16_t prescalers[] = { 1, 8, 32, 64, 128, 256, 1024 };
 
-ISR(INT0_vect) {
-    counter++;
-}
-
-static inline void initialize_timer(void) {
-    // ustaw tryb licznika
-    // COM1A = 10   -- non-inverting mode
-    // WGM1  = 1110 -- Fast PWM top=ICR1
-    // CS1   = 101  -- prescaler 1024
-    // ICR1  = 16*10^6/(frequency*1024)-1
-    // częstotliwość 16e6/(1024*(1+ICR1) = frequency Hz
+// Poniżej ~31 Hz połowa okresu nie mieści się w 8-bitowym liczniku nawet
+// przy preskalerze 1024; wtedy przerwanie porównania odlicza blink_postscaler
+// dopasowań i dopiero wtedy przełącza diodę.
+static uint16_t blink_postscaler = 1;
+static uint16_t blink_matches = 0;
 
-    TCCR1A = _BV(COM1A1);
-    TCCR1B = _BV(CS12) | _BV(CS10);
+ISR(TIMER2_COMPA_vect) {
+    if (++blink_matches == blink_postscaler) {
+        blink_matches = 0;
+        // zapis jedynki do PINx przełącza pin
+        PINB = _BV(LED);
+    }
+}
 
-    TCCR1A |= _BV(WGM11);
-    TCCR1B |= _BV(WGM13) | _BV(WGM12);
+// ustawia Timer2 na miganie z częstotliwością możliwie bliską frequency;
+// zwraca rzeczywistą częstotliwość w setnych częściach herca
+static uint32_t initialize_blink(uint16_t frequency) {
+    // dwie zmiany stanu na okres
+    const uint32_t half_period = F_CPU / 2 / frequency;
+    uint8_t select = 0;
+    uint32_t ticks = 0;
+    while (select < sizeof(prescalers) / sizeof(prescalers[0])) {
+        ticks = (half_period + prescalers[select] / 2) / prescalers[select];
+        if (ticks <= 256) {
+            break;
+        }
+        select++;
+    }
+    if (select == sizeof(prescalers) / sizeof(prescalers[0])) {
+        select--;
+        blink_postscaler = (ticks + 255) / 256;
+        ticks = (ticks + blink_postscaler / 2) / blink_postscaler;
+    }
+    if (ticks == 0) {
+        ticks = 1;
+    }
 
-    DDRB |= _BV(PB1);
+    // ustaw tryb licznika
+    // COM2A = 01 -- toggle OC2A (tylko bez postskalera)
+    // WGM2  = 010 -- CTC top=OCR2A
+    // CS2   = select + 1
+    OCR2A = ticks - 1;
+    TCCR2A = _BV(WGM21);
+    if (blink_postscaler == 1) {
+        TCCR2A |= _BV(COM2A0);
+    } else {
+        TIMSK2 |= _BV(OCIE2A);
+    }
+    TCCR2B = select + 1;
+    return F_CPU * 100 / (2 * prescalers[select] * ticks * blink_postscaler);
 }
 
 int main(void) {
-    uart_init();
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_initialize();
+    uart_setup_stdio();
 
     initialize_io();
+    // ustaw tryb uśpienia na tryb bezczynności
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    // UART działa na przerwaniach
+    sei();
 
     printf("Podaj częstotliwość migania diody...\r\n");
     uint16_t frequency;
     scanf("%" SCNu16, &frequency);
-    ICR1 = (uint32_t)16000000 / ((uint32_t)frequency * 1024) - 1;
-    OCR1A = ICR1 / 2;
-    initialize_timer();
-
-    while (1) {
-        counter = 0;
+    if (frequency == 0) {
+        frequency = 1;
+    }
+    char text[16];
+    format_fixed(text, sizeof(text), initialize_blink(frequency), 2, 2);
+    printf("Dioda miga z częstotliwością %s Hz\r\n", text);
 
-        sei();
-        _delay_ms(1000);
-        cli();
+    frequency_meter_initialize();
 
-        printf("%" PRIu16 " Hz\r\n", counter);
+    while (1) {
+        frequency_meter_result_t result;
+        if (frequency_meter_update(&result)) {
+            format_fixed(text, sizeof(text), result.frequency_centihertz, 2, 2);
+            printf("%s Hz\r\n", text);
+        }
+        // obudzi nas przerwanie miernika albo UART
+        sleep_mode();
     }
 }
@@ -1,39 +1,14 @@
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "uart.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <stdio.h>
 #include <util/delay.h>
 
-#define BAUD 9600 // baudrate
-#define UBRR_VALUE ((F_CPU) / 16 / (BAUD)-1) // zgodnie ze wzorem
-
-// inicjalizacja UART
-static inline void uart_init(void) {
-    // ustaw baudrate
-    UBRR0 = UBRR_VALUE;
-    // włącz odbiornik i nadajnik
-    UCSR0B = _BV(RXEN0) | _BV(TXEN0);
-    // ustaw format 8n1
-    UCSR0C = _BV(UCSZ00) | _BV(UCSZ01);
-}
-
-// transmisja jednego znaku
-static int uart_transmit(char data, FILE* stream) {
-    // czekaj aż transmiter gotowy
-    while (!(UCSR0A & _BV(UDRE0)))
-        ;
-    UDR0 = data;
-    return 0;
-}
-
-// odczyt jednego znaku
-static int uart_receive(FILE* stream) {
-    // czekaj aż znak dostępny
-    while (!(UCSR0A & _BV(RXC0)))
-        ;
-    return UDR0;
-}
-
-FILE uart_file;
+// Zamiast tekstu wysyłaj próbki jako binarne rekordy adc_sample (tools/telemetry)
+#define BINARY_TELEMETRY
+#undef BINARY_TELEMETRY
 
 #define CAPACITOR_MUX ADC2D
 
@@ -45,7 +20,7 @@ static inline void initialize_adc(void) {
     // ADCSRA = _BV(ADPS0) | _BV(ADPS1) | _BV(ADPS2); // preskaler 128
     // częstotliwość zegara ADC 500 kHz (16 MHz / 32)
     ADCSRA = _BV(ADPS2) | _BV(ADPS0); // preskaler 32
-    ADCSRA |= _BV(ADIE); // włącz przerwanie
+    // przerwanie włączamy dopiero na czas pomiaru, bo read_adc czeka na ADIF
     // TODO: przetestuj auto-trigger
     ADCSRA |= _BV(ADATE); // auto-trigger
     ADCSRB |= _BV(ADTS2) | _BV(ADTS1); // auto-trigger on timer 1 overflow
@@ -114,14 +89,19 @@ ISR(TIMER1_OVF_vect) {
 #define DUMPER_PIN PIND
 #define DUMPER PD4
 
+#define CAPACITOR_CHANNEL 2
+
 int main(void) {
-    uart_init();
-    fdev_setup_stream(&uart_file, uart_transmit, uart_receive, _FDEV_SETUP_RW);
-    stdin = stdout = stderr = &uart_file;
+    uart_initialize();
+    uart_setup_stdio();
+    // UART potrzebuje przerwań przez cały czas
+    sei();
 
     initialize_adc();
 
+#ifndef BINARY_TELEMETRY
     printf("Podaj częstotliwość próbkowania...\r\n");
+#endif
     uint16_t frequency;
     scanf("%" SCNu16, &frequency);
     ICR1 = (uint32_t)16000000 / ((uint32_t)frequency * 8) - 1;
@@ -129,9 +109,11 @@ int main(void) {
 
     _delay_ms(1000);
 
+#ifndef BINARY_TELEMETRY
     uint16_t before_uncharge = read_adc();
     uint32_t before_uncharge_milivolts = adc_to_milivolts(before_uncharge);
     printf("Before uncharge: %" PRIu32 "mV (%" PRIu16 ")\r\n", before_uncharge_milivolts, before_uncharge);
+#endif
 
     // włącz wyjście i ustaw na 0V aby rozładować kondensator
     DUMPER_PORT &= ~_BV(DUMPER);
@@ -139,23 +121,33 @@ int main(void) {
 
     _delay_ms(1000);
 
+#ifndef BINARY_TELEMETRY
     uint16_t after_uncharge = read_adc();
     uint32_t after_uncharge_milivolts = adc_to_milivolts(after_uncharge);
     printf("After uncharge: %" PRIu32 "mV (%" PRIu16 ")\r\n", after_uncharge_milivolts, after_uncharge);
+#endif
 
     // wyłącz wyjście aby przestać rozładowywać kondensator
     DUMPER_DDR &= ~_BV(DUMPER);
     TCNT1 = 0;
-    sei();
+    ADCSRA |= _BV(ADIE);
     START_ADC_CONVERSION;
 
     _delay_ms(3000);
-    cli();
+    ADCSRA &= ~_BV(ADIE);
     for (uint8_t index = 0; index < measurements_count; index++) {
         uint16_t measurement = measurements[index];
+#ifdef BINARY_TELEMETRY
+        const telemetry_adc_sample_t sample = { index, CAPACITOR_CHANNEL, measurement };
+        while (uart_bytes_free() < TELEMETRY_MAX_ENCODED) { }
+        TELEMETRY_SEND(adc_sample, &sample);
+#else
         uint32_t milivolts = adc_to_milivolts(measurement);
         printf("%" PRIu32 "mV (%" PRIu16 "), ", milivolts, measurement);
+#endif
     }
+    // w strumieniu binarnym są tylko rekordy; pojemność liczy wtedy odbiorca
+#ifndef BINARY_TELEMETRY
     printf("\r\nMeasurements: %u\r\n", measurements_count);
 
     uint16_t after_charge = read_adc();
@@ -201,6 +193,7 @@ int main(void) {
     uint32_t capacity_picofarads = (130 * period_microseconds * 1000) / avegare_delta_milivolts;
 
     printf("Capacity: %" PRIu32 " pF\r\n", capacity_picofarads);
+#endif
 
     while (1) { }
 }
@@ -0,0 +1,116 @@
+// Test common/relay_tune na modelu grzałki z list_11/task_1.
+//
+//     autotune [classic|no-overshoot] [setpoint d°C]
+//
+// Model grzałki z czujnikiem LM35 pochodzi z tools/simulator/plant.h
+// (stała 2 min, czujnik 8 s, opóźnienie 1 s). Regulator działa co próbkę
+// ADC (SAMPLE_RATE, jak Timer1 w list_11/task_1), wyjście
+// -PWM_TOP..PWM_TOP to wypełnienie 0..100%.
+//
+// Najpierw przekaźnik mierzy Tu i Ku, potem z wyliczonymi nastawami
+// regulator dochodzi od temperatury otoczenia do zadanej. Na stdout trafia
+// przebieg (próbka, temperatura, wyjście) co sekundę, na stderr wynik:
+// nastawy, przeregulowanie i czas ustalania (±1°C). Kod wyjścia 0, gdy
+// pomiar się udał i regulator się ustalił.
+
+#include "lm35.h"
+#include "pid.h"
+#include "plant.h"
+#include "relay_tune.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLE_RATE 61.0 // Hz
+#define PWM_TOP 128
+
+#define HYSTERESIS 3 // kody ADC
+#define TUNE_TIMEOUT_S 3600
+#define RUN_S 1800
+#define SETTLE_BAND 10.0 // d°C
+
+// ten sam model co w tools/simulator heater
+static thermal_plant_t plant = {
+    .dt = 1 / SAMPLE_RATE,
+    .ambient = 250,
+    .gain = 400,
+    .heater_tau = 120,
+    .sensor_tau = 8,
+    .dead_samples = SAMPLE_RATE,
+};
+
+// pomiar jak w list_11/task_1 (common/lm35.h), przycięty do zakresu ADC
+static int16_t to_adc(double decycelsius) {
+    const double milivolts = decycelsius_to_milivolts(decycelsius);
+    const uint16_t adc = milivolts_to_adc(milivolts < 0 ? 0 : milivolts);
+    return adc > 1023 ? 1023 : adc;
+}
+
+static double output_to_power(int16_t output) {
+    return (output + PWM_TOP) / (2.0 * PWM_TOP);
+}
+
+int main(int argc, char** argv) {
+    relay_tune_rule_t rule = RELAY_TUNE_CLASSIC;
+    if (argc > 1) {
+        if (strcmp(argv[1], "no-overshoot") == 0) {
+            rule = RELAY_TUNE_NO_OVERSHOOT;
+        } else if (strcmp(argv[1], "classic") != 0) {
+            fprintf(stderr, "usage: %s [classic|no-overshoot] [setpoint]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    const double setpoint = argc > 2 ? atof(argv[2]) : 450;
+    const int16_t goal = to_adc(setpoint);
+
+    thermal_plant_reset(&plant);
+    relay_tune_t tune;
+    relay_tune_start(&tune, goal, HYSTERESIS, PWM_TOP, -PWM_TOP, TUNE_TIMEOUT_S * SAMPLE_RATE);
+    long sample = 0;
+    while (tune.status == RELAY_TUNE_RUNNING) {
+        const int16_t output = relay_tune_update(&tune, to_adc(plant.sensor));
+        thermal_plant_step(&plant, output_to_power(output));
+        if (sample++ % (int)SAMPLE_RATE == 0) {
+            printf("%ld %.1f %d\n", sample, plant.sensor, output);
+        }
+    }
+    pid_parameters_t parameters = {
+        .setpoint_weight_p = PID_ONE,
+        .setpoint_weight_d = 0,
+        .derivative_filter_shift = 2,
+        .output_min = -PWM_TOP,
+        .output_max = PWM_TOP,
+    };
+    if (!relay_tune_gains(&tune, rule, &parameters)) {
+        fprintf(stderr, "relay experiment failed after %ld samples\n", sample);
+        return EXIT_FAILURE;
+    }
+    const double scale = 1 << PID_GAIN_FRACTION_BITS;
+    fprintf(stderr, "tuning: %.1f s, Tu = %u samples (%.1f s), a = %u codes\n", sample / SAMPLE_RATE,
+            tune.period, tune.period / SAMPLE_RATE, tune.amplitude);
+    fprintf(stderr, "gains: Kp = %.4f, Ki = %.6f, Kd = %.3f, Kt = %.6f (per sample)\n", parameters.kp / scale,
+            parameters.ki / scale, parameters.kd / scale, parameters.kt / scale);
+
+    pid_controller_t pid;
+    pid_initialize(&pid, &parameters);
+    thermal_plant_reset(&plant);
+    const long samples = RUN_S * SAMPLE_RATE;
+    double* temperatures = malloc(samples * sizeof(double));
+    for (sample = 0; sample < samples; sample++) {
+        const int16_t output = pid_update(&pid, goal, to_adc(plant.sensor));
+        temperatures[sample] = thermal_plant_step(&plant, output_to_power(output));
+        if (sample % (int)SAMPLE_RATE == 0) {
+            printf("%ld %.1f %d\n", sample, plant.sensor, output);
+        }
+    }
+    const step_response_t response = step_response(temperatures, samples, setpoint, SETTLE_BAND, 60 * SAMPLE_RATE);
+    free(temperatures);
+    fprintf(stderr, "step %.0f -> %.0f d°C: overshoot %.1f d°C, settling ", plant.ambient, setpoint,
+            response.overshoot);
+    if (response.settling_samples < 0) {
+        fprintf(stderr, "never\n");
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "%.1f s\n", response.settling_samples / SAMPLE_RATE);
+    return EXIT_SUCCESS;
+}
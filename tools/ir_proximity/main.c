@@ -0,0 +1,142 @@
+// Symulacja common/ir_proximity.c na komputerze, takt po takcie Timer2 (4 µs).
+//
+//     ir_proximity
+//
+// Model odbiornika (np. TSOP38238): wyjście przechodzi w stan niski
+// turn_on taktów po początku odbitej paczki nośnej i wraca release taktów
+// po jej końcu -- w katalogu 7-15 okresów nośnej, czyli 200-400 µs, a
+// różnica obu to zniekształcenie szerokości impulsu. Zakłócenia to krótkie
+// impulsy niskie w losowych chwilach, niezależne od nośnej. TIMER2_COMPA
+// wchodzi COMPARE_LATENCY taktów po wyzerowaniu TCNT2, więc zbocza z tego
+// czasu trafiają do PCINT0 z ustawioną flagą OCF2A, jak na procesorze.
+//
+// Każdy scenariusz trwa FRAMES ramek; w każdej wynik musi leżeć po właściwej
+// stronie progów (bez pomocy histerezy). Kod wyjścia 0, gdy wszystkie
+// przeszły.
+
+#include "ir_proximity.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define COMPARE_LATENCY 3
+#define FRAMES 8
+
+typedef struct {
+    const char* name;
+    bool reflection;
+    uint8_t turn_on; // takty od początku nośnej do stanu niskiego
+    uint8_t release; // takty od końca nośnej do stanu wysokiego
+    uint16_t noise_gap; // średni odstęp impulsów zakłóceń, 0 -- bez zakłóceń
+    bool expected;
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+    {"ciemno", false, 0, 0, 0, false},
+    {"zakłócenia", false, 0, 0, 600, false},
+    {"odbicie, odbiornik 200 µs", true, 50, 50, 0, true},
+    {"odbicie, odbiornik 400 µs", true, 100, 100, 0, true},
+    {"odbicie, impuls krótszy o 160 µs", true, 62, 22, 0, true},
+    {"odbicie, impuls dłuższy o 160 µs", true, 50, 90, 0, true},
+    {"odbicie z zakłóceniami", true, 100, 100, 600, true},
+    {"zakłócenia po odbiciu", false, 0, 0, 600, false},
+};
+
+static uint16_t carrier_ticks;
+static uint16_t release_ticks;
+static bool receiver_out;
+static uint8_t noise_ticks;
+
+// stan niski wyjścia odbiornika od odbitej nośnej
+static bool receiver_low(const scenario_t* s, bool carrier) {
+    if (s->reflection && carrier) {
+        release_ticks = 0;
+        if (++carrier_ticks >= s->turn_on) {
+            receiver_out = true;
+        }
+    } else {
+        carrier_ticks = 0;
+        if (receiver_out && ++release_ticks >= s->release) {
+            receiver_out = false;
+        }
+    }
+    return receiver_out;
+}
+
+// stan niski od zakłóceń
+static bool noise_low(const scenario_t* s) {
+    if (noise_ticks > 0) {
+        noise_ticks--;
+        return true;
+    }
+    if (s->noise_gap && rand() % s->noise_gap == 0) {
+        noise_ticks = 5 + rand() % 20;
+    }
+    return false;
+}
+
+static void set_detector(bool low) {
+    const uint8_t pin = low ? 0 : _BV(PB0);
+    if ((PINB & _BV(PB0)) != pin) {
+        PINB = (PINB & ~_BV(PB0)) | pin;
+        PCINT0_vect();
+    }
+}
+
+static bool run(const scenario_t* s) {
+    static uint32_t t = 0;
+    carrier_ticks = 0;
+    release_ticks = 0;
+    receiver_out = false;
+    noise_ticks = 0;
+    srand(1);
+
+    bool passed = true;
+    for (uint8_t frame = 0; frame < FRAMES;) {
+        const uint8_t count = t % IR_PROXIMITY_SLOT_TICKS;
+        TCNT2 = count;
+        if (count == 0 && t > 0) {
+            TIFR2 |= _BV(OCF2A);
+        }
+        const bool carrier = TCCR1A & _BV(COM1A1);
+        const bool from_receiver = receiver_low(s, carrier);
+        const bool from_noise = noise_low(s);
+        set_detector(from_receiver || from_noise);
+        if ((TIFR2 & _BV(OCF2A)) && count == COMPARE_LATENCY) {
+            TIFR2 &= ~_BV(OCF2A);
+            TIMER2_COMPA_vect();
+        }
+        t++;
+
+        ir_proximity_result_t result;
+        if (!ir_proximity_update(&result)) {
+            continue;
+        }
+        frame++;
+        const bool on_side = s->expected ? result.score >= IR_PROXIMITY_ON_THRESHOLD
+                                         : result.score <= IR_PROXIMITY_OFF_THRESHOLD;
+        const bool ok = on_side && result.detected == s->expected;
+        printf("sygnał %4u tło %4u wynik %5d %-7s %s%s\n", result.signal, result.ambient,
+               result.score, result.detected ? "wykryto" : "brak", s->name,
+               ok ? "" : "  <-- BŁĄD");
+        passed &= ok;
+    }
+    return passed;
+}
+
+int main(void) {
+    PINB = _BV(PB0); // pull-up, odbiornik w spoczynku
+    ir_proximity_initialize();
+    printf("progi: włączenie %d, wyłączenie %d\n", IR_PROXIMITY_ON_THRESHOLD,
+           IR_PROXIMITY_OFF_THRESHOLD);
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (!run(&scenarios[i])) {
+            fprintf(stderr, "scenariusz \"%s\" nie przeszedł\n", scenarios[i].name);
+            failures++;
+        }
+    }
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
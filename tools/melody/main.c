@@ -0,0 +1,248 @@
+// Koder melodii dla common/melody_decoder.h.
+//
+//     melody <nazwa> < melodia.txt > melodia.h
+//
+// Wejście to ciąg słów rozdzielonych białymi znakami:
+//     A4/4     nuta: nazwa (C..B), opcjonalnie # albo s (krzyżyk) lub b
+//              (bemol), oktawa, po ukośniku wartość (1, 2, 4, ..., 128)
+//     G3/8.    kropka wydłuża o połowę (można ich dać kilka)
+//     r/16     pauza
+//     [ ... ]2 blok zagrany 2 razy (dowolna liczba 1..255)
+//     [ ... ]* blok powtarzany bez końca
+// # na początku słowa zaczyna komentarz do końca linii.
+// Bloki można zagnieżdżać do MELODY_REPEAT_DEPTH poziomów.
+//
+// Na stdout trafia nagłówek C z tablicą <nazwa>[] PROGMEM, na stderr
+// rozmiar w porównaniu z rozwiniętym zapisem po 2 bajty na nutę.
+
+#include "melody_decoder.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SIZE 32768
+
+typedef struct {
+    size_t start; // pierwszy bajt bloku
+    int pitch; // wysokość odniesienia na początku bloku
+    long notes; // nuty w jednym przebiegu bloku
+} block_t;
+
+static uint8_t output[MAX_SIZE];
+static size_t size = 0;
+
+static block_t blocks[MELODY_REPEAT_DEPTH + 1];
+static int depth = 0;
+static long notes = 0; // nuty po rozwinięciu powtórzeń (bez bloków nieskończonych)
+
+// stan dekodera odtwarzany przez koder
+static int pitch = 60;
+static int length = MELODY_WHOLE / 4;
+static int length_known = 1; // 0 na początku bloku: przy powtórzeniu stan jest inny
+
+static int line = 1;
+
+static void fail(const char* message, const char* word) {
+    fprintf(stderr, "line %d: %s: %s\n", line, message, word);
+    exit(EXIT_FAILURE);
+}
+
+static void emit(uint8_t byte) {
+    if (size == MAX_SIZE) {
+        fail("melody too long", "");
+    }
+    output[size++] = byte;
+}
+
+static void emit_varint(unsigned value) {
+    do {
+        emit((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+        value >>= 7;
+    } while (value != 0);
+}
+
+static int parse_length(const char* text, const char* word) {
+    char* end;
+    const long value = strtol(text, &end, 10);
+    if (value < 1 || value > 128 || (value & (value - 1)) != 0) {
+        fail("bad note value", word);
+    }
+    int result = MELODY_WHOLE / value;
+    for (int dot = result / 2; *end == '.'; end++, dot /= 2) {
+        if (dot == 0) {
+            fail("too many dots", word);
+        }
+        result += dot;
+    }
+    if (*end != '\0') {
+        fail("unexpected characters", word);
+    }
+    return result;
+}
+
+static int parse_pitch(const char* text, const char** rest, const char* word) {
+    static const int semitones[] = { 9, 11, 0, 2, 4, 5, 7 }; // A..G
+    const char name = toupper((unsigned char)*text);
+    if (name < 'A' || name > 'G') {
+        fail("bad pitch", word);
+    }
+    int result = semitones[name - 'A'];
+    text++;
+    if (*text == '#' || *text == 's') {
+        result++;
+        text++;
+    } else if (*text == 'b') {
+        result--;
+        text++;
+    }
+    if (!isdigit((unsigned char)*text)) {
+        fail("missing octave", word);
+    }
+    result += (*text - '0' + 1) * 12;
+    text++;
+    if (result < 0 || result > 127) {
+        fail("pitch out of range", word);
+    }
+    *rest = text;
+    return result;
+}
+
+static void note(const char* word) {
+    const char* rest = word;
+    const int rest_note = *word == 'r' || *word == 'R';
+    const int value = rest_note ? MELODY_SILENCE : parse_pitch(word, &rest, word);
+    if (rest_note) {
+        rest++;
+    }
+    if (*rest != '/') {
+        fail("missing note value", word);
+    }
+    const int new_length = parse_length(rest + 1, word);
+    const int same = length_known && new_length == length;
+
+    if (rest_note) {
+        emit(same ? MELODY_REST_SAME : MELODY_REST);
+    } else {
+        int delta = value - pitch;
+        if (delta < -32 || delta > 31) {
+            emit(MELODY_PITCH);
+            emit(value);
+            delta = 0;
+        }
+        emit((same ? MELODY_NOTE_SAME : MELODY_NOTE) | MELODY_DELTA(delta));
+        pitch = value;
+    }
+    if (!same) {
+        emit_varint(new_length);
+    }
+    length = new_length;
+    length_known = 1;
+    notes++;
+}
+
+static void open_block(const char* word) {
+    if (depth == MELODY_REPEAT_DEPTH) {
+        fail("blocks nested too deep", word);
+    }
+    blocks[depth].start = size;
+    blocks[depth].pitch = pitch;
+    blocks[depth].notes = notes;
+    depth++;
+    length_known = 0;
+}
+
+static void close_block(const char* word) {
+    if (depth == 0) {
+        fail("unmatched ]", word);
+    }
+    const block_t* block = &blocks[--depth];
+    if (block->start == size) {
+        fail("empty block", word);
+    }
+    long count;
+    if (strcmp(word, "]*") == 0) {
+        count = 0;
+    } else {
+        char* end;
+        count = strtol(word + 1, &end, 10);
+        if (count < 1 || count > 255 || *end != '\0') {
+            fail("bad repeat count", word);
+        }
+    }
+    if (count == 1) {
+        return;
+    }
+    const size_t op = size;
+    emit(MELODY_REPEAT);
+    emit(count);
+    emit(block->pitch);
+    emit_varint(op - block->start);
+    if (count > 1) {
+        notes += (notes - block->notes) * (count - 1);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <name> < melody.txt > melody.h\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char word[64];
+    int character;
+    size_t word_length = 0;
+    int comment = 0;
+    do {
+        character = getchar();
+        if (character == '#' && word_length == 0) {
+            comment = 1;
+        }
+        if (character == EOF || isspace(character) || comment) {
+            if (word_length > 0) {
+                word[word_length] = '\0';
+                word_length = 0;
+                if (strcmp(word, "[") == 0) {
+                    open_block(word);
+                } else if (word[0] == ']') {
+                    close_block(word);
+                } else {
+                    note(word);
+                }
+            }
+            if (character == '\n') {
+                comment = 0;
+                line++;
+            }
+            continue;
+        }
+        if (word_length == sizeof(word) - 1) {
+            word[word_length] = '\0';
+            fail("word too long", word);
+        }
+        word[word_length++] = character;
+    } while (character != EOF);
+    if (depth != 0) {
+        fail("unclosed [", "");
+    }
+    emit(MELODY_END);
+
+    fprintf(stderr, "%ld notes, %zu bytes (%ld bytes at 2 bytes per note)\n", notes, size, notes * 2);
+
+    printf("#ifndef __");
+    for (const char* c = argv[1]; *c; c++) {
+        putchar(toupper((unsigned char)*c));
+    }
+    printf("_H\n#define __");
+    for (const char* c = argv[1]; *c; c++) {
+        putchar(toupper((unsigned char)*c));
+    }
+    printf("_H\n\n// Wygenerowane przez tools/melody: %ld nut w %zu bajtach.\n\n", notes, size);
+    printf("#include \"melody_decoder.h\"\n#include <avr/pgmspace.h>\n#include <stdint.h>\n\n");
+    printf("static const uint8_t %s[] PROGMEM = {", argv[1]);
+    for (size_t index = 0; index < size; index++) {
+        printf("%s0x%02X,", index % 12 == 0 ? "\n    " : " ", output[index]);
+    }
+    printf("\n};\n\n#endif\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+// Testy statystyczne dla common/random.h.
+//
+//     random xorshift [bajty] [ziarno]
+//         strumień random_byte(): kolejne słowa xorshift32, najmłodszy
+//         bajt najpierw (domyślnie 1 MB, ziarno jak w random.c)
+//     random seed [uruchomienia]
+//         ziarna z random_seed() dla symulowanych uruchomień: ADC stoi na
+//         jednej wartości i tylko czasem zmienia najmłodszy bit, licznik WDT
+//         drga o kilka obiegów; sprawdza, czy wybielanie ukrywa to obciążenie
+//     random file < dane.bin
+//         dowolne bajty, np. zrzucone z urządzenia przez UART
+//
+// Testy (poziom istotności 0.001, czyli |z| < 3.29):
+//     monobit     liczba jedynek
+//     runs        liczba serii jednakowych bitów
+//     chi2 bytes  histogram bajtów (255 stopni swobody)
+//     chi2 pairs  histogram par bajtów (65535 stopni), gdy danych wystarczy
+//     serial      korelacja kolejnych bajtów
+// Kod wyjścia 0 oznacza, że wszystkie testy przeszły.
+
+#include "random.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define Z_LIMIT 3.29
+
+static int failures = 0;
+
+static void report(const char* name, double statistic, double z) {
+    const int pass = fabs(z) < Z_LIMIT;
+    printf("%-12s %14.4f  z = %7.3f  %s\n", name, statistic, z, pass ? "PASS" : "FAIL");
+    failures += !pass;
+}
+
+static void test_monobit(const uint8_t* data, size_t size) {
+    double ones = 0;
+    for (size_t index = 0; index < size; index++) {
+        ones += __builtin_popcount(data[index]);
+    }
+    const double bits = size * 8.0;
+    report("monobit", ones / bits, (2 * ones - bits) / sqrt(bits));
+}
+
+static void test_runs(const uint8_t* data, size_t size) {
+    const double bits = size * 8.0;
+    double ones = 0;
+    double runs = 1;
+    int previous = data[0] & 1;
+    for (size_t index = 0; index < size; index++) {
+        for (int bit = 0; bit < 8; bit++) {
+            const int value = (data[index] >> bit) & 1;
+            ones += value;
+            if (index + bit > 0 && value != previous) {
+                runs++;
+            }
+            previous = value;
+        }
+    }
+    const double p = ones / bits;
+    const double expected = 2 * bits * p * (1 - p) + 1;
+    const double deviation = 2 * sqrt(2 * bits) * p * (1 - p);
+    report("runs", runs, (runs - expected) / deviation);
+}
+
+static void test_chi2(const char* name, const uint8_t* data, size_t size, int pairs) {
+    const size_t cells = pairs ? 65536 : 256;
+    const size_t samples = pairs ? size / 2 : size;
+    double* counts = calloc(cells, sizeof(double));
+    for (size_t index = 0; index < samples; index++) {
+        const size_t cell = pairs ? (data[2 * index] << 8 | data[2 * index + 1]) : data[index];
+        counts[cell]++;
+    }
+    const double expected = (double)samples / cells;
+    double chi2 = 0;
+    for (size_t cell = 0; cell < cells; cell++) {
+        chi2 += (counts[cell] - expected) * (counts[cell] - expected) / expected;
+    }
+    free(counts);
+    const double freedom = cells - 1;
+    report(name, chi2, (chi2 - freedom) / sqrt(2 * freedom));
+}
+
+// Knuth, TAOCP tom 2, 3.3.2 K
+static void test_serial(const uint8_t* data, size_t size) {
+    double sum = 0, squares = 0, products = 0;
+    for (size_t index = 0; index < size; index++) {
+        const double value = data[index];
+        sum += value;
+        squares += value * value;
+        products += value * data[(index + 1) % size];
+    }
+    const double n = size;
+    const double correlation = (n * products - sum * sum) / (n * squares - sum * sum);
+    report("serial", correlation, correlation * sqrt(n));
+}
+
+static void run_tests(const uint8_t* data, size_t size) {
+    printf("%zu bytes\n", size);
+    test_monobit(data, size);
+    test_runs(data, size);
+    test_chi2("chi2 bytes", data, size, 0);
+    if (size / 2 >= 65536 * 5) {
+        test_chi2("chi2 pairs", data, size, 1);
+    }
+    test_serial(data, size);
+}
+
+static size_t generate_xorshift(uint8_t* data, size_t size, uint32_t seed) {
+    uint32_t state = seed;
+    for (size_t index = 0; index < size; index += 4) {
+        uint32_t word = random_xorshift32(&state);
+        for (size_t byte = 0; byte < 4 && index + byte < size; byte++, word >>= 8) {
+            data[index + byte] = word;
+        }
+    }
+    return size;
+}
+
+// symulacja random_initialize(): te same pule, szum z rand()
+static size_t generate_seeds(uint8_t* data, size_t boots) {
+    srand(1);
+    for (size_t boot = 0; boot < boots; boot++) {
+        uint32_t adc = 0;
+        for (int index = 0; index < RANDOM_ADC_SAMPLES; index++) {
+            random_pool_add(&adc, 512 + (rand() < RAND_MAX / 5));
+        }
+        uint32_t watchdog = 0;
+        for (int index = 0; index < RANDOM_WDT_SAMPLES; index++) {
+            random_pool_add(&watchdog, 51200 + rand() % 5 - 2);
+        }
+        const uint32_t seed = random_seed(adc, watchdog);
+        memcpy(&data[4 * boot], &seed, 4);
+    }
+    return boots * 4;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr,
+                "usage: %s xorshift [bytes] [seed]\n"
+                "       %s seed [boots]\n"
+                "       %s file < data.bin\n",
+                argv[0], argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t size;
+    uint8_t* data;
+    if (strcmp(argv[1], "xorshift") == 0) {
+        size = argc > 2 ? strtoul(argv[2], NULL, 0) : 1 << 20;
+        const uint32_t seed = argc > 3 ? strtoul(argv[3], NULL, 0) : 2463534242UL;
+        data = malloc(size);
+        generate_xorshift(data, size, seed);
+    } else if (strcmp(argv[1], "seed") == 0) {
+        const size_t boots = argc > 2 ? strtoul(argv[2], NULL, 0) : 1 << 16;
+        data = malloc(boots * 4);
+        size = generate_seeds(data, boots);
+    } else if (strcmp(argv[1], "file") == 0) {
+        size_t capacity = 1 << 16;
+        size = 0;
+        data = malloc(capacity);
+        size_t count;
+        while ((count = fread(data + size, 1, capacity - size, stdin)) > 0) {
+            size += count;
+            if (size == capacity) {
+                capacity *= 2;
+                data = realloc(data, capacity);
+            }
+        }
+    } else {
+        fprintf(stderr, "unknown mode: %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    if (size < 16) {
+        fprintf(stderr, "not enough data\n");
+        return EXIT_FAILURE;
+    }
+
+    run_tests(data, size);
+    free(data);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
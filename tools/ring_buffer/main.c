@@ -0,0 +1,149 @@
+// Test common/ring_buffer.h na komputerze.
+//
+//     ring_buffer
+//
+// Sprawdza przepełnienie liczników head/tail przez 255, stany pełny
+// i pusty, reserve/commit i peek/consume na końcu tablicy oraz niepełne
+// write_n/read_n. Każdy nieudany warunek trafia na stderr; kod wyjścia 0,
+// gdy wszystkie przeszły.
+
+#include "ring_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIZE 8
+
+RING_BUFFER_CREATE(bytes, uint8_t, SIZE);
+RING_BUFFER_CREATE(words, uint16_t, SIZE);
+
+static int failures = 0;
+
+#define CHECK(condition)                                                     \
+    do {                                                                     \
+        if (!(condition)) {                                                  \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                      \
+        }                                                                    \
+    } while (0)
+
+// pusty bufor z licznikami ustawionymi na position
+static void words_reset(uint8_t position) {
+    words_head = position;
+    words_tail = position;
+}
+
+static void test_wrap_around(void) {
+    // licznik head przechodzi przez 255 kilka razy, indeks przez koniec tablicy
+    for (uint16_t value = 0; value < 1000; value++) {
+        CHECK(bytes_write(value & 0xFF));
+        CHECK(bytes_count() == 1);
+        uint8_t read = 0;
+        CHECK(bytes_read(&read));
+        CHECK(read == (value & 0xFF));
+        CHECK(bytes_is_empty());
+    }
+    // bufor niepusty w chwili przepełnienia liczników
+    words_reset(250);
+    for (uint16_t value = 0; value < SIZE; value++) {
+        CHECK(words_write(1000 + value));
+    }
+    CHECK(words_head == (uint8_t)(250 + SIZE));
+    CHECK(words_count() == SIZE);
+    for (uint16_t value = 0; value < SIZE; value++) {
+        uint16_t read = 0;
+        CHECK(words_read(&read));
+        CHECK(read == 1000 + value);
+    }
+}
+
+static void test_full_and_empty(void) {
+    words_reset(252);
+    CHECK(words_is_empty());
+    CHECK(!words_is_full());
+    CHECK(words_count() == 0);
+    CHECK(words_free() == SIZE);
+    uint16_t read = 0;
+    CHECK(!words_read(&read));
+
+    for (uint16_t value = 0; value < SIZE; value++) {
+        CHECK(words_write(value));
+    }
+    CHECK(words_is_full());
+    CHECK(!words_is_empty());
+    CHECK(words_count() == SIZE);
+    CHECK(words_free() == 0);
+    CHECK(!words_write(99));
+
+    CHECK(words_read(&read));
+    CHECK(read == 0);
+    CHECK(!words_is_full());
+    CHECK(words_free() == 1);
+
+    words_clear();
+    CHECK(words_is_empty());
+    CHECK(!words_read(&read));
+}
+
+static void test_reserve_commit(void) {
+    // indeks 6 z 8: do końca tablicy zostały 2 miejsca
+    words_reset(254);
+    uint16_t* data;
+    CHECK(words_reserve(&data) == 2);
+    data[0] = 10;
+    data[1] = 11;
+    words_commit(2);
+    CHECK(words_count() == 2);
+    // reszta miejsca jest od początku tablicy
+    CHECK(words_reserve(&data) == SIZE - 2);
+    for (uint8_t index = 0; index < SIZE - 2; index++) {
+        data[index] = 12 + index;
+    }
+    words_commit(SIZE - 2);
+    CHECK(words_is_full());
+    CHECK(words_reserve(&data) == 0);
+
+    const uint16_t* view;
+    CHECK(words_peek(&view) == 2);
+    CHECK(view[0] == 10 && view[1] == 11);
+    words_consume(2);
+    CHECK(words_peek(&view) == SIZE - 2);
+    for (uint8_t index = 0; index < SIZE - 2; index++) {
+        CHECK(view[index] == 12 + index);
+    }
+    words_consume(SIZE - 2);
+    CHECK(words_is_empty());
+    CHECK(words_peek(&view) == 0);
+}
+
+static void test_short_counts(void) {
+    words_reset(253);
+    const uint16_t values[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    CHECK(words_write_n(values, 5) == 5);
+    // zostały 3 miejsca, zapis przechodzi przez koniec tablicy
+    CHECK(words_write_n(values + 5, 5) == 3);
+    CHECK(words_is_full());
+    CHECK(words_write_n(values, 1) == 0);
+
+    uint16_t read[10] = { 0 };
+    CHECK(words_read_n(read, 3) == 3);
+    CHECK(read[0] == 1 && read[1] == 2 && read[2] == 3);
+    CHECK(words_read_n(read, 10) == SIZE - 3);
+    for (uint8_t index = 0; index < SIZE - 3; index++) {
+        CHECK(read[index] == 4 + index);
+    }
+    CHECK(words_read_n(read, 10) == 0);
+    CHECK(words_is_empty());
+}
+
+int main(void) {
+    test_wrap_around();
+    test_full_and_empty();
+    test_reserve_commit();
+    test_short_counts();
+    if (failures != 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,17 @@
+#ifndef __HAL_AVR_INTERRUPT_H
+#define __HAL_AVR_INTERRUPT_H
+
+// Procedury obsługi przerwań stają się zwykłymi funkcjami, które symulator
+// woła w chwilach, w których zgłosiłby je sprzęt.
+
+#define ISR(vector) void vector(void)
+
+#define sei()
+#define cli()
+
+void TIMER1_OVF_vect(void);
+void ADC_vect(void);
+void TIMER2_COMPA_vect(void);
+void PCINT0_vect(void);
+
+#endif
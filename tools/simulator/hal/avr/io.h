@@ -0,0 +1,36 @@
+#ifndef __HAL_AVR_IO_H
+#define __HAL_AVR_IO_H
+
+// Atrapa <avr/io.h> dla tools/simulator i tools/ir_proximity: rejestry to
+// zwykłe zmienne (definicje w hal.c), a bity mają numery jak w ATmega328P.
+// Zawiera tylko to, czego używają moduły kompilowane przez te narzędzia.
+
+#include <stdint.h>
+
+#define _BV(bit) (1 << (bit))
+
+extern volatile uint8_t DDRB, PORTB, PINB;
+extern volatile uint8_t ADMUX, ADCSRA, ADCSRB, DIDR0;
+extern volatile uint16_t ADC;
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+extern volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1;
+extern volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, TIMSK2, TIFR2;
+extern volatile uint8_t PCICR, PCIFR, PCMSK0;
+
+enum { PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7 };
+enum { MUX0, MUX1, MUX2, MUX3, ADLAR = 5, REFS0, REFS1 };
+enum { ADPS0, ADPS1, ADPS2, ADIE, ADIF, ADATE, ADSC, ADEN };
+enum { ADTS0, ADTS1, ADTS2 };
+enum { WGM10, WGM11, COM1B0 = 4, COM1B1, COM1A0, COM1A1 };
+enum { CS10, CS11, CS12, WGM12, WGM13, ICES1 = 6, ICNC1 };
+enum { TOIE1, OCIE1A, OCIE1B, ICIE1 = 5 };
+enum { TOV1, OCF1A, OCF1B, ICF1 = 5 };
+enum { WGM20, WGM21, COM2B0 = 4, COM2B1, COM2A0, COM2A1 };
+enum { CS20, CS21, CS22, WGM22 };
+enum { TOIE2, OCIE2A, OCIE2B };
+enum { TOV2, OCF2A, OCF2B };
+enum { PCIE0, PCIE1, PCIE2 };
+enum { PCIF0, PCIF1, PCIF2 };
+enum { PCINT0, PCINT1, PCINT2, PCINT3, PCINT4, PCINT5, PCINT6, PCINT7 };
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef __HAL_UTIL_ATOMIC_H
+#define __HAL_UTIL_ATOMIC_H
+
+// Symulacja jest jednowątkowa, więc blok atomowy wykonuje się po prostu raz.
+
+#define ATOMIC_BLOCK(type) for (int __once = 1; __once; __once = 0)
+
+#endif
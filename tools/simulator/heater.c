@@ -0,0 +1,75 @@
+// list_11/task_1: regulator co próbkę ADC (61 Hz), wyjście przez modulację
+// sigma-delta na tranzystor grzałki, skok od temperatury otoczenia,
+// 30 minut. Wzmocnienia Q16.16 jak w firmware.
+
+#include "lm35.h"
+#include "simulator.h"
+#include <stdlib.h>
+
+#define HEATER_RATE 61.0 // Hz
+#define HEATER_PWM_TOP 128
+#define HEATER_SECONDS 1800
+#define HEATER_BAND 10.0 // ±1°C
+#define HEATER_K_P (0.65 * 6.00)
+#define HEATER_K_I (0.5 * 0.10)
+#define HEATER_K_D (0.12 * 0.10)
+
+// nastawy z tools/autotune dla tego modelu
+static const check_t heater_checks[] = {
+    { 400, { 16.3, 0.0144, 4612 }, 20, 150, 2 },
+    { 450, { 16.3, 0.0144, 4612 }, 20, 180, 2 },
+};
+
+static run_t run_heater(double setpoint, gains_t gains) {
+    thermal_plant_t plant = {
+        .dt = 1 / HEATER_RATE,
+        .ambient = 250,
+        .gain = 400,
+        .heater_tau = 120,
+        .sensor_tau = 8,
+        .dead_samples = HEATER_RATE,
+    };
+    thermal_plant_reset(&plant);
+    pid_controller_t pid;
+    const pid_parameters_t parameters = make_parameters(gains, -HEATER_PWM_TOP, HEATER_PWM_TOP);
+    pid_initialize(&pid, &parameters);
+    const int16_t goal = milivolts_to_adc(decycelsius_to_milivolts(setpoint));
+
+    run_t run = { .steps = HEATER_SECONDS * HEATER_RATE };
+    double* temperatures = malloc(run.steps * sizeof(double));
+    int16_t accumulator = 0;
+    double temperature = plant.sensor;
+    const double start = now();
+    for (long step = 0; step < run.steps; step++) {
+        const double milivolts = decycelsius_to_milivolts(temperature);
+        const uint16_t adc = milivolts_to_adc(milivolts < 0 ? 0 : milivolts);
+        const int16_t output = pid_update(&pid, goal, adc > 1023 ? 1023 : adc);
+        // jak drive_mosfet() w list_11/task_1
+        accumulator += output + HEATER_PWM_TOP;
+        int on = 0;
+        if (accumulator >= 2 * HEATER_PWM_TOP) {
+            accumulator -= 2 * HEATER_PWM_TOP;
+            on = 1;
+        }
+        temperature = thermal_plant_step(&plant, on);
+        temperatures[step] = temperature;
+        if (trace != NULL && step % (long)HEATER_RATE == 0) {
+            fprintf(trace, "%.2f %.1f %.1f %d\n", step / HEATER_RATE, setpoint, temperature, output);
+        }
+    }
+    run.seconds = now() - start;
+    run.response = step_response(temperatures, run.steps, setpoint, HEATER_BAND, 60 * HEATER_RATE);
+    free(temperatures);
+    return run;
+}
+
+const loop_t loop = {
+    .unit = "d°C",
+    .rate = HEATER_RATE,
+    .band = HEATER_BAND,
+    .setpoint = 450,
+    .gains = { HEATER_K_P, HEATER_K_I, HEATER_K_D },
+    .run = run_heater,
+    .checks = heater_checks,
+    .check_count = sizeof(heater_checks) / sizeof(heater_checks[0]),
+};
@@ -0,0 +1,165 @@
+// Symulator zamkniętych pętli regulacji z list_11.
+//
+//     heater [setpoint d°C] [Kp Ki Kd]
+//     motor [setpoint kody ADC] [Kp Ki Kd]
+//     heater|motor sweep
+//     heater|motor check
+//
+// Kod sterownika jest ten sam co na płytce: common/pid, przeliczenia
+// common/lm35.h i, dla silnika, common/back_emf skompilowany z atrapą
+// rejestrów i przerwań z hal/. Pętlę zamykają modele z plant.h. Każda
+// pętla to osobny program skompilowany z DEFS swojego firmware (heater.c
+// -- list_11/task_1, Q16.16; motor.c -- list_11/task_2, Q8.8), więc
+// arytmetyka regulatora jest taka sama jak na płytce.
+//
+// Domyślne nastawy są jak w firmware. Na stdout trafia przebieg (czas,
+// wartość zadana, pomiar, wyjście regulatora), na stderr przeregulowanie,
+// czas ustalania, uchyb ustalony i czas kroku. Czas kroku (model
+// + regulator) to wyłącznie czas tego komputera, nie cykle AVR; cykle
+// pid_update na płytce mierzy list_04/task_1.
+//
+// sweep -- siatka Kp x Ki wokół domyślnych nastaw, jeden wiersz CSV na
+//     scenariusz (wzmocnienia po zaokrągleniu do formatu regulatora), na
+//     stderr liczba scenariuszy na sekundę.
+//
+// check -- stałe scenariusze z heater.c/motor.c (nastawy z tools/autotune
+//     dla grzałki, PI dla silnika) z granicami przeregulowania, czasu
+//     ustalania i uchybu ustalonego; kod wyjścia 0, gdy wszystkie mieszczą
+//     się w granicach. Na końcu przebieg z nastawami z firmware tylko do
+//     wglądu: ręczne nastawy grzałki z list_11/task_1 dają w tym modelu
+//     cykl graniczny ±13 d°C, a regulator silnika z list_11/task_2 ma tylko
+//     człon P i zostaje mu uchyb ustalony ~60 kodów. Nie wpływa on na kod
+//     wyjścia. `make check` uruchamia check obu programów.
+//
+// Pojedynczy przebieg i sweep kończą się kodem 0, gdy (każdy) przebieg
+// ustalił się w paśmie wokół wartości zadanej.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "simulator.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+FILE* trace = NULL;
+
+pid_parameters_t make_parameters(gains_t gains, int16_t output_min, int16_t output_max) {
+    const pid_parameters_t parameters = {
+        .kp = PID_GAIN(gains.kp),
+        .ki = PID_GAIN(gains.ki),
+        .kd = PID_GAIN(gains.kd),
+        .kt = gains.kp != 0 ? PID_GAIN(gains.ki / gains.kp) : 0,
+        .setpoint_weight_p = PID_ONE,
+        .setpoint_weight_d = 0,
+        .derivative_filter_shift = 2,
+        .output_min = output_min,
+        .output_max = output_max,
+    };
+    return parameters;
+}
+
+double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+// wzmocnienie po zaokrągleniu do formatu regulatora
+static double quantized(double gain) {
+    return (double)PID_GAIN(gain) / PID_ONE;
+}
+
+// ustalony to w paśmie wokół wartości zadanej, nie tylko wokół wartości końcowej
+static int settled(const run_t* run) {
+    return run->response.settling_samples >= 0 && fabs(run->response.steady_state_error) <= loop.band;
+}
+
+static void report(const run_t* run) {
+    const step_response_t* response = &run->response;
+    fprintf(stderr, "final %.1f %s, steady-state error %.1f %s\n", response->final, loop.unit,
+            response->steady_state_error, loop.unit);
+    fprintf(stderr, "overshoot %.1f %s (%.1f%%)\n", response->overshoot, loop.unit, response->overshoot_percent);
+    if (!settled(run)) {
+        fprintf(stderr, "settling: never (±%.0f %s)\n", loop.band, loop.unit);
+    } else {
+        fprintf(stderr, "settling %.2f s\n", response->settling_samples / loop.rate);
+    }
+    fprintf(stderr, "%ld steps, %.1f ns per step (host time, not AVR cycles)\n", run->steps,
+            run->seconds * 1e9 / run->steps);
+}
+
+static int sweep(void) {
+    static const double kp_factors[] = { 0.25, 0.5, 1, 2, 4 };
+    static const double ki_values[] = { 0, 0.001, 0.003, 0.01, 0.03, 0.1 };
+    int failures = 0;
+    long scenarios = 0;
+    const double start = now();
+    printf("kp,ki,kd,overshoot,settling_s,steady_state_error\n");
+    for (size_t p = 0; p < sizeof(kp_factors) / sizeof(kp_factors[0]); p++) {
+        for (size_t i = 0; i < sizeof(ki_values) / sizeof(ki_values[0]); i++) {
+            const gains_t gains = { loop.gains.kp * kp_factors[p], ki_values[i], loop.gains.kd };
+            const run_t run = loop.run(loop.setpoint, gains);
+            const step_response_t* response = &run.response;
+            printf("%g,%g,%g,%.1f,%.2f,%.1f\n", quantized(gains.kp), quantized(gains.ki), quantized(gains.kd),
+                   response->overshoot, settled(&run) ? response->settling_samples / loop.rate : -1,
+                   response->steady_state_error);
+            failures += !settled(&run);
+            scenarios++;
+        }
+    }
+    const double seconds = now() - start;
+    fprintf(stderr, "%ld scenarios in %.2f s (%.0f per second), %d not settled\n", scenarios, seconds,
+            scenarios / seconds, failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int check(void) {
+    int failures = 0;
+    for (int i = 0; i < loop.check_count; i++) {
+        const check_t* c = &loop.checks[i];
+        const run_t run = loop.run(c->setpoint, c->gains);
+        const step_response_t* response = &run.response;
+        const double settling = response->settling_samples / loop.rate;
+        const int passed = settled(&run) && response->overshoot <= c->max_overshoot &&
+                           settling <= c->max_settling && fabs(response->steady_state_error) <= c->max_error;
+        printf("setpoint %g, gains %g %g %g: overshoot %.1f (max %g), settling %.2f s (max %g), "
+               "steady-state error %.1f (max %g) %s\n",
+               c->setpoint, quantized(c->gains.kp), quantized(c->gains.ki), quantized(c->gains.kd),
+               response->overshoot, c->max_overshoot, settled(&run) ? settling : -1, c->max_settling,
+               response->steady_state_error, c->max_error, passed ? "ok" : "FAILED");
+        failures += !passed;
+    }
+    // nastawy z firmware: tylko do wglądu, nie wpływają na kod wyjścia
+    const run_t run = loop.run(loop.setpoint, loop.gains);
+    printf("firmware gains (not checked), setpoint %g: overshoot %.1f, steady-state error %.1f, %s\n",
+           loop.setpoint, run.response.overshoot, run.response.steady_state_error,
+           settled(&run) ? "settled" : "not settled");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "sweep") == 0) {
+        return sweep();
+    }
+    if (argc > 1 && strcmp(argv[1], "check") == 0) {
+        return check();
+    }
+    if (argc != 1 && argc != 2 && argc != 5) {
+        fprintf(stderr,
+                "usage: %s [setpoint] [kp ki kd]\n"
+                "       %s sweep\n"
+                "       %s check\n",
+                argv[0], argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    const double setpoint = argc > 1 ? atof(argv[1]) : loop.setpoint;
+    gains_t gains = loop.gains;
+    if (argc > 4) {
+        gains = (gains_t){ atof(argv[2]), atof(argv[3]), atof(argv[4]) };
+    }
+    trace = stdout;
+    const run_t run = loop.run(setpoint, gains);
+    report(&run);
+    return settled(&run) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,90 @@
+// list_11/task_2: Timer1 977 Hz, przerwanie przepełnienia i przerwanie ADC
+// wołane jak na płytce, wartość zadana podawana kanałem potencjometru,
+// skok od postoju, 3 s. Wzmocnienia Q8.8 i kanały ADC jak w firmware
+// (DEFS w Makefile).
+
+#include "back_emf.h"
+#include "simulator.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdlib.h>
+
+#define MOTOR_RATE (16e6 / (2 * 8 * BACK_EMF_TOP)) // Hz
+#define MOTOR_DUTY_OFFSET 512
+#define MOTOR_SECONDS 3
+#define MOTOR_BAND 10.0 // kody ADC
+#define MOTOR_K_P (0.65 * 1.00)
+#define MOTOR_K_I (0.5 * 0.00)
+#define MOTOR_K_D (0.12 * 0.00)
+
+// PI usuwa uchyb ustalony regulatora P z firmware; Ki = 2/256 to dwa
+// najmniejsze kroki Q8.8
+static const check_t motor_checks[] = {
+    { 300, { 3, 2.0 / 256, 0 }, 60, 1.5, 3 },
+    { 500, { 3, 2.0 / 256, 0 }, 10, 0.5, 3 },
+    { 700, { 3, 2.0 / 256, 0 }, 10, 1.5, 3 },
+};
+
+// regulator w funkcji obsługi back_emf
+static pid_controller_t motor_pid;
+static int16_t motor_output;
+
+static void motor_control(uint16_t speed) {
+    motor_output = pid_update(&motor_pid, back_emf_auxiliary(), speed);
+    back_emf_set_duty(motor_output + MOTOR_DUTY_OFFSET);
+}
+
+static run_t run_motor(double setpoint, gains_t gains) {
+    motor_plant_t plant = {
+        .dt = 1 / MOTOR_RATE,
+        .full_speed = 900,
+        .tau = 0.2,
+        .load = 50,
+    };
+    motor_plant_reset(&plant);
+    const pid_parameters_t parameters =
+        make_parameters(gains, -MOTOR_DUTY_OFFSET, BACK_EMF_MAX_DUTY - MOTOR_DUTY_OFFSET);
+    pid_initialize(&motor_pid, &parameters);
+    motor_output = 0;
+    back_emf_set_handler(motor_control);
+    back_emf_initialize();
+
+    run_t run = { .steps = MOTOR_SECONDS * MOTOR_RATE };
+    double* speeds = malloc(run.steps * sizeof(double));
+    double speed = plant.speed;
+    const double start = now();
+    for (long step = 0; step < run.steps; step++) {
+        // BOTTOM: OCR1A i OCR1B przechodzą z bufora, regulator zapisuje
+        // nowe wartości dopiero na następny okres
+        const uint16_t duty = OCR1A;
+        const uint16_t trigger = OCR1B;
+        TIMER1_OVF_vect();
+        if (trigger <= BACK_EMF_TOP) {
+            // pomiar w przerwie, potem kanał potencjometru
+            ADC = speed < 0 ? 0 : speed > 1023 ? 1023 : (uint16_t)speed;
+            ADC_vect();
+            ADC = setpoint;
+            ADC_vect();
+        }
+        speed = motor_plant_step(&plant, (double)duty / BACK_EMF_TOP);
+        speeds[step] = speed;
+        if (trace != NULL && step % 10 == 0) {
+            fprintf(trace, "%.4f %.0f %.1f %d\n", step / MOTOR_RATE, setpoint, speed, motor_output);
+        }
+    }
+    run.seconds = now() - start;
+    run.response = step_response(speeds, run.steps, setpoint, MOTOR_BAND, MOTOR_RATE / 5);
+    free(speeds);
+    return run;
+}
+
+const loop_t loop = {
+    .unit = "codes",
+    .rate = MOTOR_RATE,
+    .band = MOTOR_BAND,
+    .setpoint = 500,
+    .gains = { MOTOR_K_P, MOTOR_K_I, MOTOR_K_D },
+    .run = run_motor,
+    .checks = motor_checks,
+    .check_count = sizeof(motor_checks) / sizeof(motor_checks[0]),
+};
@@ -0,0 +1,69 @@
+#include "plant.h"
+#include <math.h>
+#include <string.h>
+
+void thermal_plant_reset(thermal_plant_t* plant) {
+    plant->heater = plant->ambient;
+    plant->sensor = plant->ambient;
+    memset(plant->delay, 0, sizeof(plant->delay));
+    plant->delay_index = 0;
+}
+
+double thermal_plant_step(thermal_plant_t* plant, double power) {
+    double delayed = power;
+    if (plant->dead_samples > 0) {
+        delayed = plant->delay[plant->delay_index];
+        plant->delay[plant->delay_index] = power;
+        plant->delay_index = (plant->delay_index + 1) % plant->dead_samples;
+    }
+    plant->heater += (plant->ambient + plant->gain * delayed - plant->heater) * plant->dt / plant->heater_tau;
+    plant->sensor += (plant->heater - plant->sensor) * plant->dt / plant->sensor_tau;
+    return plant->sensor;
+}
+
+void motor_plant_reset(motor_plant_t* plant) {
+    plant->speed = 0;
+}
+
+double motor_plant_step(motor_plant_t* plant, double duty) {
+    double target = plant->full_speed * duty - plant->load;
+    if (target < 0) {
+        target = 0;
+    }
+    plant->speed += (target - plant->speed) * plant->dt / plant->tau;
+    return plant->speed;
+}
+
+step_response_t step_response(const double* y, long count, double setpoint, double band, long tail) {
+    step_response_t result;
+    if (tail > count) {
+        tail = count;
+    }
+    double sum = 0;
+    for (long index = count - tail; index < count; index++) {
+        sum += y[index];
+    }
+    result.final = sum / tail;
+    result.steady_state_error = setpoint - result.final;
+
+    const double start = y[0];
+    const double direction = result.final >= start ? 1 : -1;
+    double peak = 0;
+    result.settling_samples = 0;
+    for (long index = 0; index < count; index++) {
+        const double beyond = (y[index] - result.final) * direction;
+        if (beyond > peak) {
+            peak = beyond;
+        }
+        if (fabs(y[index] - setpoint) > band) {
+            result.settling_samples = index + 1;
+        }
+    }
+    if (result.settling_samples >= count - tail) {
+        result.settling_samples = -1;
+    }
+    result.overshoot = peak;
+    const double change = fabs(result.final - start);
+    result.overshoot_percent = change > 0 ? 100 * peak / change : 0;
+    return result;
+}
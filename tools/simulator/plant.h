@@ -0,0 +1,58 @@
+#ifndef __PLANT_H
+#define __PLANT_H
+
+// Modele obiektów i ocena odpowiedzi skokowej dla tools/simulator
+// i tools/autotune.
+//
+// Grzałka: temperatura elementu dąży do ambient + gain * moc ze stałą
+// heater_tau, czujnik nadąża za nią ze stałą sensor_tau, a moc działa
+// z opóźnieniem dead_samples próbek. Silnik: prędkość (wprost w kodach ADC
+// siły przeciwelektromotorycznej) dąży do full_speed * wypełnienie - load
+// ze stałą tau. Oba modele całkowane metodą Eulera z krokiem dt.
+
+#define PLANT_MAX_DELAY 1024
+
+typedef struct {
+    double dt; // s
+    double ambient; // d°C
+    double gain; // d°C ponad otoczenie przy pełnej mocy
+    double heater_tau; // s
+    double sensor_tau; // s
+    int dead_samples;
+    // stan
+    double heater;
+    double sensor;
+    double delay[PLANT_MAX_DELAY];
+    int delay_index;
+} thermal_plant_t;
+
+typedef struct {
+    double dt; // s
+    double full_speed; // kody ADC przy pełnym wypełnieniu bez obciążenia
+    double tau; // s
+    double load; // spadek prędkości od obciążenia, w kodach ADC
+    // stan
+    double speed;
+} motor_plant_t;
+
+void thermal_plant_reset(thermal_plant_t* plant); /* Wszystko w temperaturze otoczenia */
+double thermal_plant_step(thermal_plant_t* plant, double power); /* Moc 0..1, zwraca temperaturę czujnika */
+void motor_plant_reset(motor_plant_t* plant); /* Silnik stoi */
+double motor_plant_step(motor_plant_t* plant, double duty); /* Wypełnienie 0..1, zwraca prędkość */
+
+// Ocena przebiegu y[0..count) po skoku wartości zadanej w chwili 0:
+// wartość końcowa to średnia z ostatnich tail próbek, przeregulowanie
+// liczone względem niej, a uchyb ustalony i czas ustalania (ostatnie
+// wyjście poza ±band) względem wartości zadanej. Przebieg, który
+// zatrzymał się daleko od wartości zadanej, nie jest więc ustalony.
+typedef struct {
+    double final;
+    double overshoot; // w jednostkach y, 0 bez przeregulowania
+    double overshoot_percent; // względem zmiany y
+    double steady_state_error;
+    long settling_samples; // -1, gdy y nie ustaliło się przed końcem
+} step_response_t;
+
+step_response_t step_response(const double* y, long count, double setpoint, double band, long tail);
+
+#endif
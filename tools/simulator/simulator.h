@@ -0,0 +1,51 @@
+#ifndef __SIMULATOR_H
+#define __SIMULATOR_H
+
+#include "pid.h"
+#include "plant.h"
+#include <stdio.h>
+
+// Wspólna część programów heater i motor: każdy z nich dostarcza jedną
+// pętlę (heater.c albo motor.c), a main.c ją uruchamia, ocenia i przegląda
+// nastawy.
+
+typedef struct {
+    double kp;
+    double ki;
+    double kd;
+} gains_t;
+
+typedef struct {
+    step_response_t response;
+    long steps;
+    double seconds; // czas trwania symulacji na tym komputerze
+} run_t;
+
+// Scenariusz `check`: stałe nastawy i granice jakości odpowiedzi
+typedef struct {
+    double setpoint;
+    gains_t gains;
+    double max_overshoot; // w jednostkach pomiaru
+    double max_settling; // s
+    double max_error; // |uchyb ustalony|
+} check_t;
+
+typedef struct {
+    const char* unit; // jednostka pomiaru w raporcie
+    double rate; // Hz, próbki regulatora
+    double band; // dopuszczalny uchyb wokół wartości zadanej
+    double setpoint; // domyślna wartość zadana
+    gains_t gains; // nastawy z firmware
+    run_t (*run)(double setpoint, gains_t gains);
+    const check_t* checks;
+    int check_count;
+} loop_t;
+
+extern const loop_t loop; // heater.c albo motor.c
+extern FILE* trace; // przebieg (co kilka próbek) albo NULL
+
+/* Parametry common/pid wspólne dla obu pętli */
+pid_parameters_t make_parameters(gains_t gains, int16_t output_min, int16_t output_max);
+double now(void); /* Czas monotoniczny w sekundach */
+
+#endif
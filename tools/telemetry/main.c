@@ -0,0 +1,368 @@
+// Narzędzie po stronie Linuksa do binarnej telemetrii (common/telemetry.h).
+//
+//     telemetry decode [urządzenie [baudrate]]
+//         czyta ramki z urządzenia (albo stdin) i wypisuje CSV na stdout;
+//         przed pierwszym rekordem danego typu wypisuje nagłówek "# ..."
+//     telemetry encode
+//         czyta CSV w tym samym formacie ze stdin i wypisuje ramki na stdout
+//
+// Test bez płytki przez pętlę pty:
+//     socat -d -d pty,raw,echo=0 pty,raw,echo=0      # wypisze /dev/pts/A i B
+//     ./telemetry decode /dev/pts/B &
+//     printf 'pid_sample,0,400,380,12\n' | ./telemetry encode > /dev/pts/A
+
+#define _DEFAULT_SOURCE
+#include "telemetry_frame.h"
+#include "telemetry_records.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+typedef struct {
+    uint8_t type;
+    const char* name;
+    size_t size;
+    const char* fields;
+    bool header_printed;
+} record_info_t;
+
+#define RECORD_INFO(id, name, type, fields) { id, #name, sizeof(type), fields, false },
+static record_info_t records[] = { TELEMETRY_RECORDS(RECORD_INFO) };
+#undef RECORD_INFO
+
+#define RECORDS_COUNT (sizeof(records) / sizeof(records[0]))
+
+static record_info_t* find_record_by_type(uint8_t type) {
+    for (size_t index = 0; index < RECORDS_COUNT; index++) {
+        if (records[index].type == type) {
+            return &records[index];
+        }
+    }
+    return NULL;
+}
+
+static record_info_t* find_record_by_name(const char* name) {
+    for (size_t index = 0; index < RECORDS_COUNT; index++) {
+        if (strcmp(records[index].name, name) == 0) {
+            return &records[index];
+        }
+    }
+    return NULL;
+}
+
+// Rozmiar pola w bajtach dla typu z opisu ("u16" -> 2); 0 gdy nieznany.
+static size_t field_size(const char* type, bool* is_signed) {
+    *is_signed = type[0] == 'i';
+    if (type[0] != 'i' && type[0] != 'u') {
+        return 0;
+    }
+    const int bits = atoi(type + 1);
+    if (bits != 8 && bits != 16 && bits != 32) {
+        return 0;
+    }
+    return bits / 8;
+}
+
+// Przechodzi po opisie pól "nazwa:typ,..." i woła callback dla każdego pola.
+typedef bool (*field_callback_t)(const char* name, size_t name_length, size_t size, bool is_signed,
+                                 void* context);
+
+static bool for_each_field(const record_info_t* record, field_callback_t callback, void* context) {
+    const char* cursor = record->fields;
+    while (*cursor != '\0') {
+        const char* colon = strchr(cursor, ':');
+        if (colon == NULL) {
+            return false;
+        }
+        const char* end = strchr(colon, ',');
+        char type[8] = { 0 };
+        const size_t type_length = (end != NULL ? (size_t)(end - colon) : strlen(colon)) - 1;
+        if (type_length >= sizeof(type)) {
+            return false;
+        }
+        memcpy(type, colon + 1, type_length);
+
+        bool is_signed;
+        const size_t size = field_size(type, &is_signed);
+        if (size == 0 || !callback(cursor, colon - cursor, size, is_signed, context)) {
+            return false;
+        }
+        cursor = end != NULL ? end + 1 : colon + 1 + type_length;
+    }
+    return true;
+}
+
+static bool sum_field(const char* name, size_t name_length, size_t size, bool is_signed, void* context) {
+    *(size_t*)context += size;
+    return true;
+}
+
+static bool print_field_name(const char* name, size_t name_length, size_t size, bool is_signed, void* context) {
+    printf(",%.*s", (int)name_length, name);
+    return true;
+}
+
+typedef struct {
+    const uint8_t* data;
+    size_t offset;
+} print_context_t;
+
+static bool print_field_value(const char* name, size_t name_length, size_t size, bool is_signed, void* context) {
+    print_context_t* print = context;
+    uint32_t value = 0;
+    for (size_t index = 0; index < size; index++) {
+        value |= (uint32_t)print->data[print->offset + index] << (8 * index);
+    }
+    print->offset += size;
+    if (is_signed) {
+        // rozszerz znak
+        const uint32_t sign = (uint32_t)1 << (8 * size - 1);
+        printf(",%" PRIi32, (int32_t)((value ^ sign) - sign));
+    } else {
+        printf(",%" PRIu32, value);
+    }
+    return true;
+}
+
+typedef struct {
+    char* cursor;
+    uint8_t* data;
+    size_t offset;
+} parse_context_t;
+
+static bool parse_field_value(const char* name, size_t name_length, size_t size, bool is_signed, void* context) {
+    parse_context_t* parse = context;
+    char* token = strsep(&parse->cursor, ",");
+    if (token == NULL) {
+        return false;
+    }
+    char* end;
+    const long long value = strtoll(token, &end, 0);
+    if (end == token) {
+        return false;
+    }
+    for (size_t index = 0; index < size; index++) {
+        parse->data[parse->offset + index] = (uint64_t)value >> (8 * index);
+    }
+    parse->offset += size;
+    return true;
+}
+
+// Sprawdza, czy opisy pól zgadzają się z rozmiarami struktur.
+static bool validate_records(void) {
+    for (size_t index = 0; index < RECORDS_COUNT; index++) {
+        size_t size = 0;
+        if (!for_each_field(&records[index], sum_field, &size) || size != records[index].size
+            || size > TELEMETRY_MAX_RECORD) {
+            fprintf(stderr, "record %s: field description does not match struct size %zu\n",
+                    records[index].name, records[index].size);
+            return false;
+        }
+    }
+    return true;
+}
+
+static speed_t baudrate_to_speed(long baudrate) {
+    switch (baudrate) {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 38400:
+        return B38400;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+    default:
+        return 0;
+    }
+}
+
+static int open_input(const char* path, long baudrate) {
+    const int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    if (isatty(fd)) {
+        struct termios tty;
+        if (tcgetattr(fd, &tty) != 0) {
+            perror("tcgetattr");
+            close(fd);
+            return -1;
+        }
+        cfmakeraw(&tty);
+        const speed_t speed = baudrate_to_speed(baudrate);
+        if (speed == 0) {
+            fprintf(stderr, "unsupported baudrate %ld\n", baudrate);
+            close(fd);
+            return -1;
+        }
+        cfsetispeed(&tty, speed);
+        cfsetospeed(&tty, speed);
+        tty.c_cc[VMIN] = 1;
+        tty.c_cc[VTIME] = 0;
+        if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+            perror("tcsetattr");
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+static unsigned long frames_ok = 0;
+static unsigned long frames_corrupted = 0;
+static unsigned long frames_lost = 0;
+
+static void handle_frame(const uint8_t* input, size_t length) {
+    uint8_t type, sequence, size;
+    uint8_t record[TELEMETRY_MAX_RECORD];
+    if (length == 0) {
+        return;
+    }
+    if (length > TELEMETRY_MAX_ENCODED
+        || !telemetry_frame_decode(input, length, &type, &sequence, record, &size)) {
+        frames_corrupted++;
+        return;
+    }
+
+    record_info_t* info = find_record_by_type(type);
+    if (info == NULL || info->size != size) {
+        fprintf(stderr, "unknown record type 0x%02x (%u bytes)\n", type, size);
+        frames_corrupted++;
+        return;
+    }
+
+    // numery są wspólne dla wszystkich typów, więc luka liczy się globalnie
+    static bool sequence_known = false;
+    static uint8_t last_sequence;
+    if (sequence_known) {
+        frames_lost += (uint8_t)(sequence - last_sequence - 1);
+    }
+    sequence_known = true;
+    last_sequence = sequence;
+    frames_ok++;
+
+    if (!info->header_printed) {
+        printf("# %s,sequence", info->name);
+        for_each_field(info, print_field_name, NULL);
+        printf("\n");
+        info->header_printed = true;
+    }
+    printf("%s,%u", info->name, sequence);
+    print_context_t context = { record, 0 };
+    for_each_field(info, print_field_value, &context);
+    printf("\n");
+    fflush(stdout);
+}
+
+static int decode(int fd) {
+    uint8_t frame[256];
+    size_t length = 0;
+    bool overflow = false;
+    uint8_t chunk[256];
+    ssize_t count;
+    while ((count = read(fd, chunk, sizeof(chunk))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("read");
+            return EXIT_FAILURE;
+        }
+        for (ssize_t index = 0; index < count; index++) {
+            const uint8_t data = chunk[index];
+            if (data == 0) {
+                if (overflow) {
+                    frames_corrupted++;
+                } else {
+                    handle_frame(frame, length);
+                }
+                length = 0;
+                overflow = false;
+            } else if (length < sizeof(frame)) {
+                frame[length++] = data;
+            } else {
+                overflow = true;
+            }
+        }
+    }
+    fprintf(stderr, "frames: %lu ok, %lu corrupted, %lu lost\n", frames_ok, frames_corrupted, frames_lost);
+    return EXIT_SUCCESS;
+}
+
+static int encode(void) {
+    char line[512];
+    uint8_t sequence = 0;
+    unsigned long line_number = 0;
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        char* cursor = line;
+        const char* name = strsep(&cursor, ",");
+        const record_info_t* info = find_record_by_name(name);
+        const char* sequence_token = cursor != NULL ? strsep(&cursor, ",") : NULL;
+        if (info == NULL || sequence_token == NULL) {
+            fprintf(stderr, "line %lu: unknown record\n", line_number);
+            return EXIT_FAILURE;
+        }
+        if (*sequence_token != '\0') {
+            sequence = strtoul(sequence_token, NULL, 0);
+        }
+
+        uint8_t record[TELEMETRY_MAX_RECORD];
+        parse_context_t context = { cursor, record, 0 };
+        if (!for_each_field(info, parse_field_value, &context)) {
+            fprintf(stderr, "line %lu: bad fields for %s\n", line_number, info->name);
+            return EXIT_FAILURE;
+        }
+
+        uint8_t output[TELEMETRY_MAX_ENCODED];
+        const uint8_t length = telemetry_frame_encode(info->type, sequence, record, info->size, output);
+        fwrite(output, 1, length, stdout);
+        sequence++;
+    }
+    fflush(stdout);
+    return EXIT_SUCCESS;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s decode [device [baudrate]]\n       %s encode\n", program, program);
+}
+
+int main(int argc, char** argv) {
+    if (!validate_records()) {
+        return EXIT_FAILURE;
+    }
+    if (argc >= 2 && strcmp(argv[1], "decode") == 0 && argc <= 4) {
+        int fd = STDIN_FILENO;
+        if (argc >= 3) {
+            const long baudrate = argc == 4 ? strtol(argv[3], NULL, 10) : 9600;
+            fd = open_input(argv[2], baudrate);
+            if (fd < 0) {
+                return EXIT_FAILURE;
+            }
+        }
+        return decode(fd);
+    }
+    if (argc == 2 && strcmp(argv[1], "encode") == 0) {
+        return encode();
+    }
+    usage(argv[0]);
+    return EXIT_FAILURE;
+}
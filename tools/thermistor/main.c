@@ -0,0 +1,124 @@
+// Generator tablicy termistora dla common/thermistor.h.
+//
+//     thermistor divider <vref> <rezystor> <R0> <T0> <B> [przesunięcie]
+//         termistor w dolnej gałęzi dzielnika zasilanego z vref:
+//         R_t = V_t * R / (vref - V_t)
+//     thermistor current <vref> <prąd> <R0> <T0> <B> [przesunięcie]
+//         termistor zasilany źródłem prądowym: R_t = V_t / I
+//
+// Przesunięcie to THERMISTOR_TABLE_SHIFT (krok tablicy 2^n kodów, domyślnie
+// 4); inne niż domyślne trzeba też przekazać kompilatorowi w Makefile.
+//
+// V_t = ADC * vref / 1024, T = B / (ln(R_t / R0) + B / T0) (model Beta).
+// Tablica trafia na stdout jako nagłówek C, na stderr maksymalny błąd
+// interpolacji w zakresie 0..100°C.
+
+#include "thermistor.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// zakres przycięcia [d°C]; poza nim wzór i tak nie opisuje czujnika
+#define MIN_DECYCELSIUS -550
+#define MAX_DECYCELSIUS 1500
+
+// zakres [d°C], w którym raportujemy błąd interpolacji; przy skrajnych
+// kodach ADC krzywa jest bardzo stroma i błąd rośnie
+#define ERROR_MIN_DECYCELSIUS 0
+#define ERROR_MAX_DECYCELSIUS 1000
+
+typedef struct {
+    int divider;
+    double vref;
+    double parameter; // rezystor dzielnika albo prąd źródła
+    double r0;
+    double t0;
+    double beta;
+} circuit_t;
+
+// temperatura [d°C] dla (ułamkowego) kodu ADC
+static double temperature(const circuit_t* circuit, double adc) {
+    const double voltage = adc * circuit->vref / 1024;
+    const double resistance = circuit->divider ? voltage * circuit->parameter / (circuit->vref - voltage)
+                                               : voltage / circuit->parameter;
+    const double kelvins = circuit->beta / (log(resistance / circuit->r0) + circuit->beta / circuit->t0);
+    const double decycelsius = (kelvins - 273.15) * 10;
+    // NTC: temperatura maleje z kodem ADC; R_t bliskie 0 albo nieskończoności
+    // daje nan albo temperaturę <= 0 K, czyli odpowiednio skrajnie gorąco
+    // albo zimno
+    if (isnan(decycelsius) || kelvins <= 0) {
+        return adc < 512 ? MAX_DECYCELSIUS : MIN_DECYCELSIUS;
+    }
+    if (decycelsius > MAX_DECYCELSIUS) {
+        return MAX_DECYCELSIUS;
+    }
+    if (decycelsius < MIN_DECYCELSIUS) {
+        return MIN_DECYCELSIUS;
+    }
+    return decycelsius;
+}
+
+static int interpolate(const int* table, int shift, int adc) {
+    const int index = adc >> shift;
+    const int fraction = adc & ((1 << shift) - 1);
+    return table[index] + (((table[index + 1] - table[index]) * fraction) >> shift);
+}
+
+int main(int argc, char** argv) {
+    if ((argc != 7 && argc != 8) || (strcmp(argv[1], "divider") != 0 && strcmp(argv[1], "current") != 0)) {
+        fprintf(stderr,
+                "usage: %s divider <vref> <resistor> <R0> <T0> <B> [shift]\n"
+                "       %s current <vref> <current> <R0> <T0> <B> [shift]\n",
+                argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    const circuit_t circuit = {
+        strcmp(argv[1], "divider") == 0, atof(argv[2]), atof(argv[3]), atof(argv[4]), atof(argv[5]), atof(argv[6]),
+    };
+
+    const int shift = argc == 8 ? atoi(argv[7]) : THERMISTOR_TABLE_SHIFT;
+    if (shift < 1 || shift > 6) {
+        fprintf(stderr, "shift must be in 1..6\n");
+        return EXIT_FAILURE;
+    }
+    const int step = 1 << shift;
+    const int size = (1024 >> shift) + 1;
+    int table[(1024 >> 1) + 1];
+    for (int index = 0; index < size; index++) {
+        table[index] = lround(temperature(&circuit, index * step));
+    }
+
+    double max_error = 0;
+    int max_error_adc = 0;
+    for (int adc = 0; adc < 1024; adc++) {
+        const double exact = temperature(&circuit, adc);
+        if (exact < ERROR_MIN_DECYCELSIUS || exact > ERROR_MAX_DECYCELSIUS) {
+            continue;
+        }
+        const double error = fabs(interpolate(table, shift, adc) - exact);
+        if (error > max_error) {
+            max_error = error;
+            max_error_adc = adc;
+        }
+    }
+    fprintf(stderr, "max interpolation error: %.2f d°C at ADC %d\n", max_error, max_error_adc);
+
+    printf("#ifndef __THERMISTOR_TABLE_H\n#define __THERMISTOR_TABLE_H\n\n");
+    printf("// Wygenerowane przez tools/thermistor:\n//    ");
+    for (int index = 1; index < argc; index++) {
+        printf(" %s", argv[index]);
+    }
+    printf("\n// Maksymalny błąd interpolacji w zakresie %d..%d d°C: %.2f d°C.\n\n", ERROR_MIN_DECYCELSIUS,
+           ERROR_MAX_DECYCELSIUS, max_error);
+    printf("#include \"thermistor.h\"\n#include <avr/pgmspace.h>\n#include <stdint.h>\n\n");
+    printf("#if THERMISTOR_TABLE_SHIFT != %d\n", shift);
+    printf("#error \"table generated for -DTHERMISTOR_TABLE_SHIFT=%d\"\n#endif\n\n", shift);
+    printf("// temperatura [d°C] dla ADC = 0, %d, ..., 1024\n", step);
+    printf("static const int16_t thermistor_table[THERMISTOR_TABLE_SIZE] PROGMEM = {");
+    for (int index = 0; index < size; index++) {
+        printf("%s%d,", index % 8 == 0 ? "\n    " : " ", table[index]);
+    }
+    printf("\n};\n\n#endif\n");
+    return EXIT_SUCCESS;
+}